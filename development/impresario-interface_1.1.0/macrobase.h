@@ -0,0 +1,696 @@
+/****************************************************************************************************
+**   Impresario Interface - Image Processing Engineering System applying Reusable Interactive Objects
+**   This file is part of the Impresario Interface.
+**
+**   Copyright (C) 2015, 2020  Lars Libuda
+**   All rights reserved.
+**
+**   Redistribution and use in source and binary forms, with or without
+**   modification, are permitted provided that the following conditions are met:
+**       * Redistributions of source code must retain the above copyright
+**         notice, this list of conditions and the following disclaimer.
+**       * Redistributions in binary form must reproduce the above copyright
+**         notice, this list of conditions and the following disclaimer in the
+**         documentation and/or other materials provided with the distribution.
+**       * Neither the name of the copyright holder nor the
+**         names of its contributors may be used to endorse or promote products
+**         derived from this software without specific prior written permission.
+**
+**   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+**   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+*****************************************************************************************************/
+#ifndef MACROBASE_H_
+#define MACROBASE_H_
+
+#include "libinterface.h"
+#include <cassert>
+#include <cstdlib>
+#include <typeinfo>
+#include <string>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <set>
+#include <type_traits>
+#if defined(__GNUC__)
+  #include <cxxabi.h>
+#endif
+
+//------------------------------------------
+// Helper classes for determining type names
+//------------------------------------------
+template <typename T>
+struct TypeName {
+  static std::string get() {
+    std::string strTypeName;
+#if defined(__GNUC__)
+    int status;
+    char* szTypeName = abi::__cxa_demangle(typeid(T).name(), nullptr, nullptr, &status);
+    strTypeName = std::string(szTypeName);
+    free(szTypeName);
+#else
+    strTypeName = std::string(typeid(T).name());
+    // if the type name contains "class ", we will erase this to make this type
+    // name compatible with those created by GCC
+    std::size_t pos = strTypeName.find("class ",0);
+    while(pos != std::string::npos)
+    {
+      strTypeName.erase(pos,6);
+      pos = strTypeName.find("class ",0);
+    }
+    // if the type name contains an asterix with leading white space, we'll erase the
+    // white space to make this type name compatible with those created by GCC
+    pos = strTypeName.find(" *",0);
+    while(pos != std::string::npos)
+    {
+      strTypeName.erase(pos,1);
+      pos = strTypeName.find(" *",0);
+    }
+    // if the type name contains the suffix __ptr64, we'll erase the
+    // suffix to make this type name compatible with those created by GCC
+    pos = strTypeName.find(" __ptr64",0);
+    while(pos != std::string::npos)
+    {
+      strTypeName.erase(pos,8);
+      pos = strTypeName.find(" __ptr64",0);
+    }
+#endif
+    return strTypeName;
+  }
+};
+
+template <>
+struct TypeName<std::string> {
+  static std::string get() {
+    return std::string("std::string");
+  }
+};
+
+template <>
+struct TypeName<std::wstring> {
+  static std::string get() {
+    return std::string("std::wstring");
+  }
+};
+
+//------------------------------------------
+// Helper function for determining type ids
+//------------------------------------------
+// The id is the 64-bit FNV-1a hash of the type name. It is equal for equal types in all libraries.
+inline unsigned long long typeIdFromName(const std::string& typeName) {
+  unsigned long long id = 14695981039346656037ULL;
+  for(std::string::const_iterator it = typeName.begin(); it != typeName.end(); ++it) {
+    id ^= static_cast<unsigned char>(*it);
+    id *= 1099511628211ULL;
+  }
+  return id;
+}
+
+//------------------------------------------
+// Class ValueBase
+//------------------------------------------
+class ValueBase {
+public:
+  ValueBase(const ValueBase&) = delete;
+  ValueBase& operator=(const ValueBase&) = delete;
+  ValueBase(ValueBase&&) = delete;
+  ValueBase& operator=(ValueBase&&) = delete;
+  virtual ~ValueBase() = default;
+
+  const std::wstring& getName() const            { return m_strName; }
+  const std::wstring& getDescription() const     { return m_strDescription; }
+  DataDescriptor* getDescriptorPtr()             { return &m_dataDescriptor; }
+
+protected:
+  ValueBase(const std::wstring& strName, const std::wstring& strDescription, void* dataPtr, const std::string& typeName) :
+    m_strName{strName}, m_strDescription{strDescription}, m_strTypeName{typeName}, m_dataDescriptor{} {
+    m_dataDescriptor.name = m_strName.c_str();
+    m_dataDescriptor.description = m_strDescription.c_str();
+    m_dataDescriptor.valuePtr = dataPtr;
+    m_dataDescriptor.next = nullptr;
+    m_dataDescriptor.type = m_strTypeName.c_str();
+    m_dataDescriptor.typeId = typeIdFromName(m_strTypeName);
+  }
+
+private:
+  std::wstring   m_strName;
+  std::wstring   m_strDescription;
+  std::string    m_strTypeName;
+  DataDescriptor m_dataDescriptor;
+};
+
+//------------------------------------------
+// Class MacroInput
+//------------------------------------------
+template <typename T>
+class MacroInput : public ValueBase {
+public:
+  MacroInput(const MacroInput&) = delete;
+  MacroInput& operator=(const MacroInput&) = delete;
+  MacroInput(MacroInput&&) = delete;
+  MacroInput& operator=(MacroInput&&) = delete;
+
+  MacroInput(const std::wstring& strName, const std::wstring& strDescription) : ValueBase{strName,strDescription,&m_ptValue,TypeName<T>::get()} {
+  }
+
+  ~MacroInput() override = default;
+
+  const T* readAccess() const { return m_ptValue; }
+
+private:
+  T* m_ptValue{nullptr};
+};
+
+//------------------------------------------
+// Class OutputBase
+//------------------------------------------
+class OutputBase : public ValueBase {
+public:
+  OutputBase(const OutputBase&) = delete;
+  OutputBase& operator=(const OutputBase&) = delete;
+  OutputBase(OutputBase&&) = delete;
+  OutputBase& operator=(OutputBase&&) = delete;
+
+  ~OutputBase() override = default;
+
+  // methods to handle the ring of output slots. The slot written during frame n is n % getSlotCount().
+  virtual unsigned int getSlotCount() const = 0;
+  virtual void*        getSlotPtr(unsigned int slot) = 0;
+  virtual void         selectSlot(unsigned int frame) = 0;
+
+protected:
+  OutputBase(const std::wstring& strName, const std::wstring& strDescription, void* dataPtr, const std::string& typeName) :
+    ValueBase{strName,strDescription,dataPtr,typeName} {
+  }
+};
+
+//------------------------------------------
+// Class MacroOuput
+//------------------------------------------
+template <typename T>
+class MacroOutput : public OutputBase {
+public:
+  MacroOutput(const MacroOutput&) = delete;
+  MacroOutput& operator=(const MacroOutput&) = delete;
+  MacroOutput(MacroOutput&&) = delete;
+  MacroOutput& operator=(MacroOutput&&) = delete;
+
+  MacroOutput(const std::wstring& strName, const std::wstring& strDescription, unsigned int slots = 1) :
+    OutputBase{strName,strDescription,nullptr,TypeName<T>::get()}, m_uiSlots{(slots > 0) ? slots : 1}, m_ptSlots{new T[m_uiSlots]{}} {
+    getDescriptorPtr()->valuePtr = &m_ptSlots[0];
+  }
+
+  ~MacroOutput() override = default;
+
+  T& writeAccess() { return m_ptSlots[m_uiWriteSlot]; }
+
+  unsigned int getSlotCount() const override        { return m_uiSlots; }
+  void*        getSlotPtr(unsigned int slot) override { return (slot < m_uiSlots) ? &m_ptSlots[slot] : nullptr; }
+  void         selectSlot(unsigned int frame) override  { m_uiWriteSlot = frame % m_uiSlots; }
+
+private:
+  unsigned int         m_uiSlots;
+  unsigned int         m_uiWriteSlot{0};
+  std::unique_ptr<T[]> m_ptSlots;
+};
+
+//------------------------------------------
+// Class ValueParameter
+//------------------------------------------
+class ValueParameter : public ValueBase {
+public:
+  ValueParameter(const ValueParameter&) = delete;
+  ValueParameter& operator=(const ValueParameter&) = delete;
+  ValueParameter(ValueParameter&&) = delete;
+  ValueParameter& operator=(ValueParameter&&) = delete;
+
+  ValueParameter(const std::wstring& strName, const std::wstring& strDescription, void* dataPtr, const std::string& typeName) :
+    ValueBase{strName,strDescription,dataPtr,typeName} {
+  }
+
+  ~ValueParameter() override = default;
+
+  // abstract methods to set and get a parameter as string, a malformed string leaves the value unchanged
+  virtual bool setValueAsString(const std::wstring& strValue) = 0;
+  virtual const std::wstring& getValueAsString() const = 0;
+
+  // abstract methods to set and get a parameter in its raw representation
+  virtual ParameterType getValueType() const = 0;
+  virtual bool setValueData(const void* data, unsigned int size) = 0;
+  virtual const void* getValueData(unsigned int* size) const = 0;
+};
+
+//------------------------------------------
+// Class ParameterValueData and specializations
+//------------------------------------------
+union ParameterRawValue {
+  long long intValue;
+  double    doubleValue;
+};
+
+// Parameters of types without raw representation are exchanged as string only
+template <typename T, typename Enable = void>
+struct ParameterValueData {
+  static const ParameterType type = ParamText;
+
+  static bool fromData(T&, const void*, unsigned int) {
+    return false;
+  }
+
+  static const void* toData(const T&, ParameterRawValue&, unsigned int* size) {
+    *size = 0;
+    return nullptr;
+  }
+};
+
+template <typename T>
+struct ParameterValueData<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T,bool>::value && !std::is_same<T,wchar_t>::value && (sizeof(T) > 1)>::type> {
+  static const ParameterType type = ParamInt;
+
+  static bool fromData(T& value, const void* data, unsigned int size) {
+    if (size != sizeof(long long)) return false;
+    value = static_cast<T>(*static_cast<const long long*>(data));
+    return true;
+  }
+
+  static const void* toData(const T& value, ParameterRawValue& raw, unsigned int* size) {
+    raw.intValue = static_cast<long long>(value);
+    *size = sizeof(long long);
+    return &raw.intValue;
+  }
+};
+
+template <typename T>
+struct ParameterValueData<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+  static const ParameterType type = ParamDouble;
+
+  static bool fromData(T& value, const void* data, unsigned int size) {
+    if (size != sizeof(double)) return false;
+    value = static_cast<T>(*static_cast<const double*>(data));
+    return true;
+  }
+
+  static const void* toData(const T& value, ParameterRawValue& raw, unsigned int* size) {
+    raw.doubleValue = static_cast<double>(value);
+    *size = sizeof(double);
+    return &raw.doubleValue;
+  }
+};
+
+template <>
+struct ParameterValueData<bool> {
+  static const ParameterType type = ParamBool;
+
+  static bool fromData(bool& value, const void* data, unsigned int size) {
+    if (size != sizeof(long long)) return false;
+    value = (*static_cast<const long long*>(data) != 0);
+    return true;
+  }
+
+  static const void* toData(const bool& value, ParameterRawValue& raw, unsigned int* size) {
+    raw.intValue = (value) ? 1 : 0;
+    *size = sizeof(long long);
+    return &raw.intValue;
+  }
+};
+
+template <typename T>
+struct ParameterValueData<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+  static const ParameterType type = ParamEnum;
+
+  static bool fromData(T& value, const void* data, unsigned int size) {
+    if (size != sizeof(long long)) return false;
+    value = static_cast<T>(*static_cast<const long long*>(data));
+    return true;
+  }
+
+  static const void* toData(const T& value, ParameterRawValue& raw, unsigned int* size) {
+    raw.intValue = static_cast<long long>(value);
+    *size = sizeof(long long);
+    return &raw.intValue;
+  }
+};
+
+template <>
+struct ParameterValueData<std::vector<unsigned char>> {
+  static const ParameterType type = ParamBlob;
+
+  static bool fromData(std::vector<unsigned char>& value, const void* data, unsigned int size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    value.assign(bytes,bytes + size);
+    return true;
+  }
+
+  static const void* toData(const std::vector<unsigned char>& value, ParameterRawValue&, unsigned int* size) {
+    *size = static_cast<unsigned int>(value.size());
+    return value.data();
+  }
+};
+
+//------------------------------------------
+// Class ParameterValueConverter and specializations
+//------------------------------------------
+template <typename T, typename Enable = void>
+class ParameterValueConverter {
+public:
+  virtual T fromString(const std::wstring& strValue) const {
+    std::basic_istringstream< wchar_t,std::char_traits<wchar_t>,std::allocator<wchar_t> > iss(strValue);
+    T value;
+    iss >> value;
+    return value;
+  }
+
+  virtual std::wstring toString(const T& value) const {
+    std::basic_ostringstream< wchar_t,std::char_traits<wchar_t>,std::allocator<wchar_t> > oss;
+    oss << value;
+    return std::wstring(oss.str());
+  }
+};
+
+template <>
+class ParameterValueConverter<std::wstring> {
+public:
+  virtual std::wstring fromString(const std::wstring& strValue) const {
+    return strValue;
+  }
+
+  virtual std::wstring toString(const std::wstring& value) const {
+    return value;
+  }
+};
+
+template <typename T>
+class ParameterValueConverter<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+public:
+  virtual T fromString(const std::wstring& strValue) const {
+    std::basic_istringstream< wchar_t,std::char_traits<wchar_t>,std::allocator<wchar_t> > iss(strValue);
+    long long value = 0;
+    iss >> value;
+    return static_cast<T>(value);
+  }
+
+  virtual std::wstring toString(const T& value) const {
+    return std::to_wstring(static_cast<long long>(value));
+  }
+};
+
+// binary data is represented by a string of hexadecimal digits, malformed strings throw std::invalid_argument
+template <>
+class ParameterValueConverter<std::vector<unsigned char>> {
+public:
+  virtual std::vector<unsigned char> fromString(const std::wstring& strValue) const {
+    if (strValue.length() % 2 != 0) throw std::invalid_argument("odd number of hexadecimal digits");
+    std::vector<unsigned char> value;
+    value.reserve(strValue.length() / 2);
+    for(std::size_t pos = 0; pos < strValue.length(); pos += 2) {
+      value.push_back(static_cast<unsigned char>((hexDigit(strValue[pos]) << 4) | hexDigit(strValue[pos + 1])));
+    }
+    return value;
+  }
+
+  virtual std::wstring toString(const std::vector<unsigned char>& value) const {
+    static const wchar_t digits[] = L"0123456789abcdef";
+    std::wstring strValue;
+    strValue.reserve(value.size() * 2);
+    for(auto byte : value) {
+      strValue += digits[byte >> 4];
+      strValue += digits[byte & 0x0F];
+    }
+    return strValue;
+  }
+
+private:
+  static unsigned char hexDigit(wchar_t c) {
+    if (c >= L'0' && c <= L'9') return static_cast<unsigned char>(c - L'0');
+    if (c >= L'a' && c <= L'f') return static_cast<unsigned char>(c - L'a' + 10);
+    if (c >= L'A' && c <= L'F') return static_cast<unsigned char>(c - L'A' + 10);
+    throw std::invalid_argument("invalid hexadecimal digit");
+  }
+};
+
+template <>
+class ParameterValueConverter<std::string> {
+public:
+  virtual std::string fromString(const std::wstring& strValue) const {
+    auto str = new char[strValue.length() + 1];
+  #ifdef _MSC_VER
+    size_t      outSize;
+    mbstate_t   conversionState;
+    memset(&conversionState,0,sizeof(conversionState));
+    const wchar_t* wstr = strValue.c_str();
+    wcsrtombs_s(&outSize, str, strValue.length() + 1, &wstr, strValue.length(), &conversionState);
+  #else
+    wcstombs(str,strValue.c_str(),strValue.length() + 1);
+  #endif
+    std::string string(str);
+    delete [] str;
+    return string;
+  }
+
+  virtual std::wstring toString(const std::string& value) const {
+    auto wstr = new wchar_t[value.length() + 1];
+  #ifdef _MSC_VER
+    size_t      outSize;
+    mbstate_t   conversionState;
+    memset(&conversionState,0,sizeof(conversionState));
+    const char* cstr = value.c_str();
+    mbsrtowcs_s(&outSize, wstr, value.length() + 1, &cstr, value.length(), &conversionState);
+  #else
+    mbstowcs(wstr,value.c_str(),value.length() + 1);
+  #endif
+    std::wstring wstring(wstr);
+    delete [] wstr;
+    return wstring;
+  }
+};
+
+//------------------------------------------
+// Class MacroParameter
+//------------------------------------------
+template <typename T>
+class MacroParameter : public ValueParameter {
+public:
+  MacroParameter(const MacroParameter&) = delete;
+  MacroParameter& operator=(const MacroParameter&) = delete;
+  MacroParameter(MacroParameter&&) = delete;
+  MacroParameter& operator=(MacroParameter&&) = delete;
+
+  MacroParameter(const std::wstring& strName, const std::wstring& strDescription, const T& tDefaultValue, const std::wstring& qmlUIComponent, const std::wstring& qmlUIProperties, const ParameterValueConverter<T>& converter) :
+    ValueParameter{strName,strDescription,0,TypeName<T>::get()}, m_converter{converter}, m_tValue{tDefaultValue}, m_tDefaultValue{tDefaultValue}, m_bStringValid{false}, m_rawValue{} {
+    m_strAttributes = qmlUIComponent + L'|' + qmlUIProperties;
+    DataDescriptor* data = getDescriptorPtr();
+    assert(data != nullptr);
+    data->valuePtr = reinterpret_cast<void*>(const_cast<wchar_t*>(m_strAttributes.c_str()));
+  }
+
+  ~MacroParameter() override = default;
+
+  // the string representation is created on request only
+  void     setValue(const T& tValue) { m_tValue = tValue; m_bStringValid = false; }
+  const T& getValue() const          { return m_tValue; }
+  const T& getDefault() const        { return m_tDefaultValue; }
+  
+  bool setValueAsString(const std::wstring& strValue) override {
+    try {
+      m_tValue = m_converter.fromString(strValue);
+    }
+    catch(const std::invalid_argument&) {
+      return false;
+    }
+    m_strValue = strValue;
+    m_bStringValid = true;
+    return true;
+  }
+
+  const std::wstring& getValueAsString() const override {
+    if (!m_bStringValid) {
+      m_strValue = m_converter.toString(m_tValue);
+      m_bStringValid = true;
+    }
+    return m_strValue;
+  }
+
+  ParameterType getValueType() const override {
+    return ParameterValueData<T>::type;
+  }
+
+  bool setValueData(const void* data, unsigned int size) override {
+    if (!ParameterValueData<T>::fromData(m_tValue,data,size)) return false;
+    m_bStringValid = false;
+    return true;
+  }
+
+  const void* getValueData(unsigned int* size) const override {
+    return ParameterValueData<T>::toData(m_tValue,m_rawValue,size);
+  }
+
+private:
+  ParameterValueConverter<T> m_converter;
+  T                          m_tValue;
+  T                          m_tDefaultValue;
+  mutable std::wstring       m_strValue;
+  mutable bool               m_bStringValid;
+  mutable ParameterRawValue  m_rawValue;
+  std::wstring               m_strAttributes;
+};
+
+//------------------------------------------
+// Class MacroBase
+//------------------------------------------
+class MacroBase {
+  friend class MacroAPIWrapper;
+public:
+  MacroBase(const MacroBase&) = delete;
+  MacroBase& operator=(const MacroBase&) = delete;
+  MacroBase(MacroBase&&) = delete;
+  MacroBase& operator=(MacroBase&&) = delete;
+
+  // standard constructor
+  MacroBase() = default;
+
+  // standard destructor
+  virtual ~MacroBase() = default;
+
+  // methods to read private attributes
+  const   std::wstring& getName() const                    { return m_strMacroName; }
+  const   std::wstring& getGroup() const                   { return m_strMacroGroup; }
+  const   std::wstring& getCreator() const                 { return m_strMacroCreator; }
+  const   std::wstring& getDescription() const             { return m_strMacroDescription; }
+  const   std::wstring& getErrorMsg() const                { return m_strMacroMsg; }
+  const   std::wstring& getPropertyWidgetComponent() const { return m_strPropWidgetFile; }
+  virtual MacroType     getType() const                    { return Macro; }
+
+  // methods for executing macro
+  enum Status {
+    Ok,
+    Stop,
+    Error
+  };
+  using ParameterSet = std::set<unsigned int>;
+
+  // methods to be overwritten in derived classes to perfrom required actions
+  virtual Status onInit()  { return Ok; }
+  virtual Status onApply() { return Ok; }
+  virtual Status onExit()  { return Ok; }
+  virtual void   onParametersChanged(ParameterSet&) {}
+
+protected:
+
+  // API methods to set up derived classes
+  void setName(const std::wstring& strName)                              { m_strMacroName = strName; }
+  void setGroup(const std::wstring& strGroup)                            { m_strMacroGroup = strGroup; }
+  void setCreator(const std::wstring& strCreator)                        { m_strMacroCreator = strCreator; }
+  void setDescription(const std::wstring& strDescription)                { m_strMacroDescription = strDescription; }
+  void setErrorMsg(const std::wstring& strErrorMsg = std::wstring{})     { m_strMacroMsg = strErrorMsg; }
+  void setPropertyWidgetComponent(const std::wstring& strPropWidgetFile) { m_strPropWidgetFile = strPropWidgetFile; }
+
+  // API methods to set up and access macro inputs
+  template<typename T>
+  bool addInput(const std::wstring& name, const std::wstring& description) {
+    if (name.empty()) {
+      return false;
+    }
+    auto input = std::unique_ptr<ValueBase>(new MacroInput<T>{name,description});
+    if (!m_vecInput.empty()) {
+      auto descr = m_vecInput.back()->getDescriptorPtr();
+      descr->next = input->getDescriptorPtr();
+    }
+    m_vecInput.push_back(std::move(input));
+    return true;
+  }
+
+  template<typename T>
+  const T* accessInput(std::size_t index) {
+    assert(index >= 0 && index < m_vecInput.size());
+    auto input = dynamic_cast<MacroInput<T>*>(m_vecInput.at(index).get());
+    auto value = input->readAccess();
+    return value;
+  }
+
+  // API methods to set up and access macro outputs. An output with more than one slot allows
+  // Impresario to run this macro on the next frame while successors still read the previous one.
+  template<typename T>
+  bool addOutput(const std::wstring& name, const std::wstring& description, unsigned int slots = 1) {
+    if (name.empty()) {
+      return false;
+    }
+    auto output = std::unique_ptr<ValueBase>(new MacroOutput<T>{name,description,slots});
+    if (!m_vecOutput.empty()) {
+      auto descr = m_vecOutput.back()->getDescriptorPtr();
+      descr->next = output->getDescriptorPtr();
+    }
+    m_vecOutput.push_back(std::move(output));
+    return true;
+  }
+
+  template<typename T>
+  T& accessOutput(std::size_t index) {
+    assert(index >= 0 && index < m_vecOutput.size());
+    auto output = dynamic_cast<MacroOutput<T>*>(m_vecOutput.at(index).get());
+    return output->writeAccess();
+  }
+
+    // API methods to set up and access macro parameters
+  template<typename T>
+  bool addParameter(const std::wstring& name, const std::wstring& description, const T& tDefaultValue, const std::wstring& qmlUIComponent = L"", const std::wstring& qmlUIProperties = L"", const ParameterValueConverter<T>& converter = ParameterValueConverter<T>()) {
+    if (name.empty()) {
+      return false;
+    }
+    auto param = std::unique_ptr<ValueBase>(new MacroParameter<T>{name,description,tDefaultValue,qmlUIComponent,qmlUIProperties,converter});
+    if (!m_vecParams.empty()) {
+      auto descr = m_vecParams.back()->getDescriptorPtr();
+      descr->next = param->getDescriptorPtr();
+    }
+    m_vecParams.push_back(std::move(param));
+    return true;
+  }
+
+  template<typename T>
+  const T& getParameterValue(std::size_t index) {
+    assert(index >= 0 && index < m_vecParams.size());
+    auto param = dynamic_cast<MacroParameter<T>*>(m_vecParams.at(index).get());
+    return param->getValue();
+  }
+
+  template<typename T>
+  void setParameterValue(std::size_t index, const T& value) {
+    assert(index >= 0 && index < m_vecParams.size());
+    auto param = dynamic_cast<MacroParameter<T>*>(m_vecParams.at(index).get());
+    if (value != param->getValue()) {
+      param->setValue(value);
+      notifyParameterChanged(static_cast<MacroHandle>(this),static_cast<unsigned int>(index));
+    }
+  }
+
+private:
+  // data type to hold inputs, outputs, and parameters
+  using ValueVector = std::vector<std::unique_ptr<ValueBase>>;
+
+  // these three methods are called by friend class MacroAPIWrapper only
+  const ValueVector& getInputs() const     { return m_vecInput; }
+  const ValueVector& getOutputs() const    { return m_vecOutput; }
+  const ValueVector& getParameters() const { return m_vecParams; }
+
+  // attributes describing the macro class by its name, group, creator, and additional text
+  std::wstring m_strMacroName;
+  std::wstring m_strMacroGroup;
+  std::wstring m_strMacroCreator;
+  std::wstring m_strMacroDescription;
+  std::wstring m_strMacroMsg;
+  std::wstring m_strPropWidgetFile;
+  ValueVector  m_vecInput;
+  ValueVector  m_vecOutput;
+  ValueVector  m_vecParams;
+};
+
+#endif /* MACROBASE_H_ */
@@ -0,0 +1,581 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+
+#include "appbenchmark.h"
+#include "appmacro.h"
+#include "appmacromanager.h"
+#include <QElapsedTimer>
+#include <QBuffer>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryFile>
+#include <QSet>
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+namespace app
+{
+  //-----------------------------------------------------------------------
+  // Class BenchmarkVertexData
+  //-----------------------------------------------------------------------
+  BenchmarkVertexData::BenchmarkVertexData() : graph::VertexData()
+  {
+    setSignature("benchmark.vertex");
+    for(int i = 0; i < InputPins; ++i)
+    {
+      addPinData(graph::PinData::Ptr(new BenchmarkPinData(QString("in%1").arg(i),graph::Defines::Incoming)));
+    }
+    addPinData(graph::PinData::Ptr(new BenchmarkPinData("out",graph::Defines::Outgoing)));
+  }
+
+  graph::VertexData::Ptr BenchmarkVertexData::clone()
+  {
+    return graph::VertexData::Ptr(new BenchmarkVertexData());
+  }
+
+  //-----------------------------------------------------------------------
+  // Class BenchmarkGraph
+  //-----------------------------------------------------------------------
+  void BenchmarkGraph::invalidate()
+  {
+    QMutexLocker lock(&mutex);
+    adjacencySnapshot.clear();
+    componentsValid = false;
+    componentMapValid = false;
+    topologicalOrderUpdatedRequired = true;
+    topologicalOrderIncremental = false;
+    strongComponentsUpdatedRequired = true;
+  }
+
+  //-----------------------------------------------------------------------
+  // Class GraphBenchmark
+  //-----------------------------------------------------------------------
+  GraphBenchmark::GraphBenchmark(QObject* parent) : QObject(parent), results(), out(stdout), err(stderr)
+  {
+  }
+
+  QString GraphBenchmark::shapeName(Shape shape)
+  {
+    switch(shape)
+    {
+      case Chain:
+        return "chain";
+      case Fan:
+        return "fan";
+      case Diamonds:
+        return "diamonds";
+      case RandomDag:
+        return "random dag";
+      case Layered:
+        return "layered";
+      case WideLayered:
+        return "wide layered";
+      case Cycles:
+        return "cycles";
+      default:
+        return QString();
+    }
+  }
+
+  void GraphBenchmark::run(int maxVertices)
+  {
+    results.clear();
+    out << qSetFieldWidth(12) << Qt::left << "Shape" << qSetFieldWidth(10) << Qt::right << "Vertices" << "Edges"
+        << qSetFieldWidth(2) << "" << qSetFieldWidth(20) << Qt::left << "Operation" << qSetFieldWidth(8) << Qt::right << "Runs"
+        << qSetFieldWidth(14) << "Time [ms]" << qSetFieldWidth(0) << Qt::endl;
+    for(int count = 10; count <= maxVertices; count *= 10)
+    {
+      for(int shape = 0; shape < Shape_End; ++shape)
+      {
+        runShape(static_cast<Shape>(shape),count);
+      }
+    }
+  }
+
+  QVector<GraphBenchmark::EdgeSpec> GraphBenchmark::generateEdges(Shape shape, int count)
+  {
+    QVector<EdgeSpec> edgeSpecs;
+    switch(shape)
+    {
+      case Chain:
+        for(int i = 1; i < count; ++i)
+        {
+          edgeSpecs.append(EdgeSpec(i - 1,i));
+        }
+        break;
+      case Fan:
+        for(int i = 1; i < count; ++i)
+        {
+          edgeSpecs.append(EdgeSpec(0,i));
+        }
+        break;
+      case Diamonds:
+        // tip -> left, tip -> right, left -> bottom, right -> bottom, bottom is the next tip
+        for(int tip = 0; tip + 3 < count; tip += 3)
+        {
+          edgeSpecs.append(EdgeSpec(tip,tip + 1));
+          edgeSpecs.append(EdgeSpec(tip,tip + 2));
+          edgeSpecs.append(EdgeSpec(tip + 1,tip + 3));
+          edgeSpecs.append(EdgeSpec(tip + 2,tip + 3));
+        }
+        break;
+      case RandomDag:
+      {
+        // up to three predecessors out of the 64 previous vertices, same graph on every platform
+        quint32 seed = 12345;
+        for(int i = 1; i < count; ++i)
+        {
+          seed = seed * 1664525u + 1013904223u;
+          int predecessors = 1 + (seed >> 16) % 3;
+          for(int k = 0; k < predecessors; ++k)
+          {
+            seed = seed * 1664525u + 1013904223u;
+            int window = qMin(i,64);
+            edgeSpecs.append(EdgeSpec(i - 1 - static_cast<int>((seed >> 16) % window),i));
+          }
+        }
+        break;
+      }
+      case Layered:
+      case WideLayered:
+      {
+        // every vertex is connected to its up to three neighbours in the layer before,
+        // layers have 8 vertices or the wide graph consists of 10 layers
+        const int width = (shape == Layered) ? 8 : qMax(8,count / 10);
+        for(int i = width; i < count; ++i)
+        {
+          int pos = i % width;
+          int layerBegin = i - pos - width;
+          for(int k = qMax(0,pos - 1); k <= qMin(width - 1,pos + 1); ++k)
+          {
+            edgeSpecs.append(EdgeSpec(layerBegin + k,i));
+          }
+        }
+        break;
+      }
+      case Cycles:
+        // chain with a feedback edge from every eighth vertex to the vertex seven steps before,
+        // ordered on its strong components without recursion, so it runs up to the full size
+        for(int i = 1; i < count; ++i)
+        {
+          edgeSpecs.append(EdgeSpec(i - 1,i));
+          if (i % 8 == 0)
+          {
+            edgeSpecs.append(EdgeSpec(i,i - 7));
+          }
+        }
+        break;
+      default:
+        break;
+    }
+    return edgeSpecs;
+  }
+
+  void GraphBenchmark::createElements(graph::ElementManager& manager, int count, const QVector<EdgeSpec>& edgeSpecs, QList<graph::Vertex::Ptr>& vertices, QList<graph::Edge::Ptr>& edges)
+  {
+    QVector<graph::Vertex::PinList> inputs;
+    QVector<graph::Pin::Ptr> outputs;
+    QVector<int> connections(count,0);
+    for(int i = 0; i < count; ++i)
+    {
+      graph::Vertex::Ptr vertex = manager.createVertexInstance("benchmark.vertex");
+      vertices.append(vertex);
+      inputs.append(vertex->pins(graph::Defines::Incoming));
+      outputs.append(vertex->pins(graph::Defines::Outgoing).first());
+    }
+    // every input pin accepts a single edge
+    foreach(EdgeSpec spec, edgeSpecs)
+    {
+      int pin = connections[spec.second]++;
+      Q_ASSERT(pin < BenchmarkVertexData::InputPins);
+      edges.append(manager.createEdgeInstance(outputs[spec.first],inputs[spec.second][pin],"benchmark.edge"));
+    }
+  }
+
+  void GraphBenchmark::addElements(graph::GraphBase& graphRef, const QList<graph::Vertex::Ptr>& vertices, const QList<graph::Edge::Ptr>& edges)
+  {
+    foreach(graph::Vertex::Ptr vertex, vertices)
+    {
+      graphRef.addVertex(vertex);
+    }
+    foreach(graph::Edge::Ptr edge, edges)
+    {
+      graphRef.addEdge(edge);
+    }
+  }
+
+  void GraphBenchmark::pasteElements(graph::ElementManager& manager, const QByteArray& xml, QList<graph::Vertex::Ptr>& vertices, QList<graph::Edge::Ptr>& edges)
+  {
+    // same steps as SceneEditor::pasteElementItemsFromClipboard without scene items
+    QXmlStreamReader stream(xml);
+    if (!stream.readNextStartElement() || stream.name() != "SceneEditorClipboard") return;
+    QMap<QUuid,graph::Pin::Ptr> pinMap;
+    while(stream.readNextStartElement())
+    {
+      QString signature = stream.attributes().value("dataTypeSignature").toString();
+      if (stream.name() == "vertex")
+      {
+        graph::Vertex::Ptr vertexPtr = manager.createVertexInstance(signature);
+        if (!vertexPtr.isNull() && vertexPtr->load(stream))
+        {
+          vertices.append(vertexPtr);
+          const graph::Vertex::PinMap& pins = vertexPtr->pins();
+          for(graph::Vertex::PinMap::const_iterator it = pins.begin(); it != pins.end(); ++it)
+          {
+            pinMap.insert(it.value()->id(),it.value());
+          }
+        }
+        else
+        {
+          stream.skipCurrentElement();
+        }
+      }
+      else
+      {
+        QUuid pinSrcId = QUuid(stream.attributes().value("srcPinId").toString());
+        QUuid pinDstId = QUuid(stream.attributes().value("destPinId").toString());
+        graph::Edge::Ptr edgePtr;
+        if (pinMap.contains(pinSrcId) && pinMap.contains(pinDstId))
+        {
+          edgePtr = manager.createEdgeInstance(pinMap[pinSrcId],pinMap[pinDstId],signature);
+        }
+        if (!edgePtr.isNull() && edgePtr->load(stream))
+        {
+          edges.append(edgePtr);
+        }
+        else
+        {
+          stream.skipCurrentElement();
+        }
+      }
+    }
+    // pasted elements get new ids which are re-keyed in the element manager
+    for(QMap<QUuid,graph::Pin::Ptr>::iterator it = pinMap.begin(); it != pinMap.end(); ++it)
+    {
+      it.value()->setId(QUuid::createUuid());
+    }
+    foreach(graph::Vertex::Ptr vertex, vertices)
+    {
+      vertex->setId(QUuid::createUuid());
+    }
+    foreach(graph::Edge::Ptr edge, edges)
+    {
+      edge->setId(QUuid::createUuid());
+    }
+  }
+
+  void GraphBenchmark::runShape(Shape shape, int count)
+  {
+    graph::ElementManager manager;
+    manager.registerVertexDataType(graph::VertexData::Ptr(new BenchmarkVertexData()));
+    graph::EdgeData::Ptr edgeType = graph::EdgeData::Ptr(new graph::EdgeData());
+    edgeType->setSignature("benchmark.edge");
+    manager.registerEdgeDataType(edgeType);
+    QVector<EdgeSpec> edgeSpecs = generateEdges(shape,count);
+    // small graphs are processed several times to get measurable times
+    const int runs = qMax(1,10000 / count);
+    QElapsedTimer timer;
+
+    BenchmarkGraph testGraph;
+    {
+      QList<graph::Vertex::Ptr> vertices;
+      QList<graph::Edge::Ptr> edges;
+      createElements(manager,count,edgeSpecs,vertices,edges);
+      timer.start();
+      testGraph.beginUpdate();
+      addElements(testGraph,vertices,edges);
+      testGraph.endUpdate();
+      addResult(shape,testGraph,"add (transaction)",1,timer.nsecsElapsed());
+    }
+    // without transaction the order is updated after each element, acyclic graphs are relabeled
+    // locally while graphs with cycles are ordered from scratch, quadratic for large graphs
+    if (count <= 10000 || shape != Cycles)
+    {
+      BenchmarkGraph singleGraph;
+      QList<graph::Vertex::Ptr> vertices;
+      QList<graph::Edge::Ptr> edges;
+      createElements(manager,count,edgeSpecs,vertices,edges);
+      timer.start();
+      addElements(singleGraph,vertices,edges);
+      addResult(shape,singleGraph,"add",1,timer.nsecsElapsed());
+    }
+
+    qint64 nsecs = 0;
+    for(int i = 0; i < runs; ++i)
+    {
+      testGraph.invalidate();
+      timer.start();
+      testGraph.adjacency();
+      nsecs += timer.nsecsElapsed();
+    }
+    addResult(shape,testGraph,"adjacency",runs,nsecs);
+    nsecs = 0;
+    for(int i = 0; i < runs; ++i)
+    {
+      testGraph.invalidate();
+      testGraph.adjacency();
+      timer.start();
+      testGraph.topologicalOrder();
+      nsecs += timer.nsecsElapsed();
+    }
+    addResult(shape,testGraph,"topologicalOrder",runs,nsecs);
+    nsecs = 0;
+    for(int i = 0; i < runs; ++i)
+    {
+      testGraph.invalidate();
+      testGraph.adjacency();
+      timer.start();
+      testGraph.strongComponents();
+      nsecs += timer.nsecsElapsed();
+    }
+    addResult(shape,testGraph,"strongComponents",runs,nsecs);
+    nsecs = 0;
+    for(int i = 0; i < runs; ++i)
+    {
+      testGraph.invalidate();
+      testGraph.adjacency();
+      timer.start();
+      testGraph.components();
+      nsecs += timer.nsecsElapsed();
+    }
+    addResult(shape,testGraph,"components",runs,nsecs);
+
+    QList<graph::Vertex::Ptr> vertexList = testGraph.vertexList();
+    timer.start();
+    for(int i = 0; i < runs; ++i)
+    {
+      foreach(graph::Vertex::Ptr vertex, vertexList)
+      {
+        manager.vertexFromId(vertex->id());
+      }
+    }
+    addResult(shape,testGraph,"vertexFromId (all)",runs,timer.nsecsElapsed());
+
+    // up to 100 vertices and the edges between them are copied like in the editor and pasted
+    // again into the manager holding all instances of the graph
+    QByteArray clipboard;
+    {
+      QSet<graph::Vertex*> copied;
+      QXmlStreamWriter stream(&clipboard);
+      stream.writeStartDocument();
+      stream.writeStartElement("SceneEditorClipboard");
+      for(int i = 0; i < qMin(count,100); ++i)
+      {
+        vertexList[i]->save(stream);
+        copied.insert(vertexList[i].data());
+      }
+      foreach(graph::Edge::Ptr edge, testGraph.edgeList())
+      {
+        if (copied.contains(&edge->srcPin()->vertex()) && copied.contains(&edge->destPin()->vertex()))
+        {
+          edge->save(stream);
+        }
+      }
+      stream.writeEndElement();
+      stream.writeEndDocument();
+    }
+    nsecs = 0;
+    for(int i = 0; i < runs; ++i)
+    {
+      QList<graph::Vertex::Ptr> pastedVertices;
+      QList<graph::Edge::Ptr> pastedEdges;
+      timer.start();
+      pasteElements(manager,clipboard,pastedVertices,pastedEdges);
+      nsecs += timer.nsecsElapsed();
+      foreach(graph::Edge::Ptr edge, pastedEdges)
+      {
+        manager.deleteEdgeInstance(edge);
+      }
+      foreach(graph::Vertex::Ptr vertex, pastedVertices)
+      {
+        manager.deleteVertexInstance(vertex);
+      }
+    }
+    addResult(shape,testGraph,"paste",runs,nsecs);
+
+    QByteArray xml;
+    timer.start();
+    for(int i = 0; i < runs; ++i)
+    {
+      xml.clear();
+      QBuffer buffer(&xml);
+      buffer.open(QIODevice::WriteOnly);
+      QXmlStreamWriter stream(&buffer);
+      testGraph.save(stream);
+    }
+    addResult(shape,testGraph,"save",runs,timer.nsecsElapsed());
+    // every load creates new element instances, so graphs are loaded only once
+    BenchmarkGraph loadedGraph;
+    QXmlStreamReader stream(xml);
+    timer.start();
+    if (!loadedGraph.load(stream,manager))
+    {
+      err << QString(tr("Loading %1 with %2 vertices failed: %3")).arg(shapeName(shape)).arg(count).arg(stream.errorString()) << Qt::endl;
+    }
+    addResult(shape,loadedGraph,"load",1,timer.nsecsElapsed());
+
+    // binary files are read from a temporary file, so loading maps it into memory like regular files
+    QTemporaryFile binaryFile;
+    if (!binaryFile.open())
+    {
+      err << QString(tr("Cannot create temporary file for binary format: %1")).arg(binaryFile.errorString()) << Qt::endl;
+      return;
+    }
+    timer.start();
+    for(int i = 0; i < runs; ++i)
+    {
+      binaryFile.resize(0);
+      binaryFile.seek(0);
+      graph::BinaryWriter writer;
+      testGraph.save(writer);
+      writer.write(binaryFile);
+    }
+    addResult(shape,testGraph,"save (binary)",runs,timer.nsecsElapsed());
+    binaryFile.flush();
+    binaryFile.seek(0);
+    BenchmarkGraph binaryGraph;
+    timer.start();
+    graph::BinaryReader reader(binaryFile);
+    if (reader.hasError() || !binaryGraph.load(reader,manager))
+    {
+      err << QString(tr("Loading %1 with %2 vertices from binary format failed: %3")).arg(shapeName(shape)).arg(count).arg(reader.errorString()) << Qt::endl;
+    }
+    addResult(shape,binaryGraph,"load (binary)",1,timer.nsecsElapsed());
+  }
+
+  void GraphBenchmark::runDispatch(const QStringList& macroNames)
+  {
+    // a single call is too short for the timer, so calls are timed in batches
+    const int batches = 10;
+    const int calls = 100000;
+    QList<graph::VertexData::Ptr> prototypes;
+    MacroManager::instance().iterateVertexDataTypes(GraphBenchmark::collectMacro,&macroNames,&prototypes);
+    QStringList found;
+    foreach(graph::VertexData::Ptr prototype, prototypes)
+    {
+      graph::VertexData::Ptr instance = prototype->clone();
+      Macro* macro = qobject_cast<Macro*>(instance.data());
+      if (macro == 0 || macro->start() > 1)
+      {
+        err << QString(tr("Macro '%1' could not be started.")).arg(static_cast<const Macro*>(prototype.data())->getName()) << Qt::endl;
+        continue;
+      }
+      found.append(macro->getName());
+      // complete call as done for each frame of a process graph, for macros doing nothing this is the dispatch overhead
+      QElapsedTimer timer;
+      qint64 nsecs = 0;
+      for(int i = 0; i < batches; ++i)
+      {
+        timer.start();
+        for(int j = 0; j < calls; ++j)
+        {
+          macro->apply();
+        }
+        nsecs += timer.nsecsElapsed();
+      }
+      addResult(macro->getName(),1,0,QString("apply x%1").arg(calls),batches,nsecs);
+      macro->stop();
+    }
+    foreach(const QString& name, macroNames)
+    {
+      if (!found.contains(name))
+      {
+        err << QString(tr("Macro '%1' not found in loaded libraries.")).arg(name) << Qt::endl;
+      }
+    }
+  }
+
+  bool GraphBenchmark::collectMacro(graph::VertexData::Ptr macroPtr, va_list args)
+  {
+    const QStringList* names = va_arg(args,const QStringList*);
+    QList<graph::VertexData::Ptr>* prototypes = va_arg(args,QList<graph::VertexData::Ptr>*);
+    const Macro* macro = qobject_cast<const Macro*>(macroPtr.data());
+    if (macro != 0 && names->contains(macro->getName()))
+    {
+      prototypes->append(macroPtr);
+    }
+    return true;
+  }
+
+  void GraphBenchmark::addResult(Shape shape, const graph::GraphBase& graphRef, const QString& operation, int runs, qint64 nsecs)
+  {
+    addResult(shapeName(shape),graphRef.countVertices(),graphRef.countEdges(),operation,runs,nsecs);
+  }
+
+  void GraphBenchmark::addResult(const QString& shape, int vertices, int edges, const QString& operation, int runs, qint64 nsecs)
+  {
+    Result result;
+    result.shape = shape;
+    result.vertices = vertices;
+    result.edges = edges;
+    result.operation = operation;
+    result.runs = runs;
+    result.nsecs = nsecs / runs;
+    results.append(result);
+    out << qSetFieldWidth(12) << Qt::left << result.shape << qSetFieldWidth(10) << Qt::right << result.vertices << result.edges
+        << qSetFieldWidth(2) << "" << qSetFieldWidth(20) << Qt::left << result.operation << qSetFieldWidth(8) << Qt::right << result.runs
+        << qSetFieldWidth(14) << QString::number(result.nsecs / 1000000.0,'f',3) << qSetFieldWidth(0) << Qt::endl;
+  }
+
+  bool GraphBenchmark::save(const QString& fileName) const
+  {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+      err << QString(tr("Cannot write benchmark results to file '%1'.")).arg(QDir::toNativeSeparators(fileName)) << Qt::endl;
+      return false;
+    }
+    if (QFileInfo(fileName).suffix().toLower() == "json")
+    {
+      QJsonArray list;
+      foreach(const Result& result, results)
+      {
+        QJsonObject entry;
+        entry["shape"] = result.shape;
+        entry["vertices"] = result.vertices;
+        entry["edges"] = result.edges;
+        entry["operation"] = result.operation;
+        entry["runs"] = result.runs;
+        entry["nsecs"] = result.nsecs;
+        list.append(entry);
+      }
+      QJsonObject root;
+      root["unit"] = QString("ns");
+      root["results"] = list;
+      file.write(QJsonDocument(root).toJson());
+    }
+    else
+    {
+      QTextStream csv(&file);
+      csv << "shape,vertices,edges,operation,runs,nsecs" << Qt::endl;
+      foreach(const Result& result, results)
+      {
+        csv << result.shape << ',' << result.vertices << ',' << result.edges << ',' << result.operation << ',' << result.runs << ',' << result.nsecs << Qt::endl;
+      }
+    }
+    return file.error() == QFileDevice::NoError;
+  }
+
+}
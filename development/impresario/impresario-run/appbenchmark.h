@@ -0,0 +1,124 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+#ifndef APPBENCHMARK_H
+#define APPBENCHMARK_H
+
+#include "graphmain.h"
+#include "graphdata.h"
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QPair>
+#include <QByteArray>
+#include <QStringList>
+#include <QTextStream>
+
+namespace app
+{
+  // Vertex and edge types without any processing used to build synthetic graphs
+  class BenchmarkPinData : public graph::PinData
+  {
+    Q_OBJECT
+  public:
+    BenchmarkPinData(const QString id, graph::Defines::PinDirectionType direction) : graph::PinData(id,direction)
+    {
+    }
+  };
+
+  class BenchmarkVertexData : public graph::VertexData
+  {
+    Q_OBJECT
+  public:
+    enum
+    {
+      InputPins = 4
+    };
+
+    BenchmarkVertexData();
+
+    virtual graph::VertexData::Ptr clone();
+  };
+
+  // Gives the benchmark access to the cached results of a directed graph
+  class BenchmarkGraph : public graph::DirectedGraph
+  {
+    Q_OBJECT
+  public:
+    void invalidate();
+  };
+
+  // Times the graph core on synthetic graphs of growing size and the dispatch of calls into
+  // macro libraries and writes the results as CSV or JSON (if file name ends with .json) to compare builds.
+  class GraphBenchmark : public QObject
+  {
+    Q_OBJECT
+    Q_DISABLE_COPY(GraphBenchmark)
+  public:
+    enum Shape
+    {
+      Chain,
+      Fan,
+      Diamonds,
+      RandomDag,
+      Layered,
+      WideLayered,
+      Cycles,
+      Shape_End
+    };
+
+    GraphBenchmark(QObject* parent = 0);
+
+    void run(int maxVertices);
+    void runDispatch(const QStringList& macroNames);
+    bool save(const QString& fileName) const;
+
+    static QString shapeName(Shape shape);
+
+  private:
+    struct Result
+    {
+      QString shape;
+      int     vertices;
+      int     edges;
+      QString operation;
+      int     runs;
+      qint64  nsecs;
+    };
+
+    typedef QPair<int,int> EdgeSpec;
+
+    static QVector<EdgeSpec> generateEdges(Shape shape, int count);
+    static void createElements(graph::ElementManager& manager, int count, const QVector<EdgeSpec>& edgeSpecs, QList<graph::Vertex::Ptr>& vertices, QList<graph::Edge::Ptr>& edges);
+    static void addElements(graph::GraphBase& graphRef, const QList<graph::Vertex::Ptr>& vertices, const QList<graph::Edge::Ptr>& edges);
+    static void pasteElements(graph::ElementManager& manager, const QByteArray& xml, QList<graph::Vertex::Ptr>& vertices, QList<graph::Edge::Ptr>& edges);
+    void runShape(Shape shape, int count);
+    void addResult(Shape shape, const graph::GraphBase& graphRef, const QString& operation, int runs, qint64 nsecs);
+    void addResult(const QString& shape, int vertices, int edges, const QString& operation, int runs, qint64 nsecs);
+    static bool collectMacro(graph::VertexData::Ptr macroPtr, va_list args);
+
+    QList<Result> results;
+    QTextStream   out;
+    mutable QTextStream err;
+  };
+
+}
+#endif // APPBENCHMARK_H
@@ -0,0 +1,212 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+
+#include "apprunner.h"
+#include "appmacro.h"
+#include "appmacromanager.h"
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QThread>
+#include <QTimer>
+#include <QFile>
+#include <QDir>
+#include <QXmlStreamReader>
+#include <QElapsedTimer>
+
+namespace app
+{
+  volatile std::sig_atomic_t GraphRunner::stopRequested = 0;
+
+  GraphRunner::GraphRunner(QObject* parent) : QObject(parent), processGraph(new ProcessGraph()), processGraphCtrl(0), out(stdout), err(stderr), runTime(0), verbose(false)
+  {
+    connect(&syslog::Logger::instance(),&syslog::Logger::changedMsgCount,this,&GraphRunner::printLogEntry);
+  }
+
+  GraphRunner::~GraphRunner()
+  {
+    delete processGraphCtrl;
+    // macro instances have to be released before their libraries are unloaded
+    delete processGraph;
+    MacroManager::instance().unloadPrototypes();
+  }
+
+  void GraphRunner::loadLibraries(const QStringList& dirs)
+  {
+    // libraries are loaded asynchronously, wait until all are registered
+    QEventLoop loop;
+    connect(&MacroManager::instance(),SIGNAL(loadPrototypesFinished()),&loop,SLOT(quit()),Qt::QueuedConnection);
+    MacroManager::instance().loadPrototypes(dirs);
+    loop.exec();
+  }
+
+  bool GraphRunner::loadGraph(const QString& fileName)
+  {
+    QFile graphFile(fileName);
+    if (!graphFile.open(QIODevice::ReadOnly))
+    {
+      syslog::error(QString(tr("Cannot open file '%1'.")).arg(QDir::toNativeSeparators(fileName)),tr("Process Graph"));
+      return false;
+    }
+    bool loaded = false;
+    QString message;
+    if (graph::BinaryFormat::isBinary(graphFile))
+    {
+      graph::BinaryReader stream(graphFile);
+      loaded = !stream.hasError() && processGraph->load(stream,MacroManager::instance());
+      message = stream.errorString();
+    }
+    else
+    {
+      QXmlStreamReader stream(&graphFile);
+      loaded = processGraph->load(stream,MacroManager::instance());
+      message = stream.errorString();
+    }
+    if (!loaded)
+    {
+      syslog::error(fileName + ": " + message,tr("Process Graph"));
+      syslog::error(QString(tr("File '%1' not loaded.")).arg(QDir::toNativeSeparators(fileName)),tr("Process Graph"));
+      return false;
+    }
+    if (!message.isEmpty())
+    {
+      syslog::warning(fileName + ": " + message,tr("Process Graph"));
+    }
+    syslog::info(QString(tr("%1: Opened process graph with %2 macros.")).arg(processGraph->name()).arg(processGraph->countVertices()),tr("Process Graph"));
+    return true;
+  }
+
+  bool GraphRunner::setParameter(const QString& assignment)
+  {
+    // expected format: <macro name or instance id>.<parameter name>=<value>
+    int posValue = assignment.indexOf('=');
+    int posParam = assignment.lastIndexOf('.',posValue);
+    if (posValue < 0 || posParam <= 0)
+    {
+      syslog::error(QString(tr("Invalid parameter assignment '%1'. Expected <macro>.<parameter>=<value>.")).arg(assignment),tr("Parameters"));
+      return false;
+    }
+    QString macroName = assignment.left(posParam);
+    QString paramName = assignment.mid(posParam + 1,posValue - posParam - 1);
+    QString value = assignment.mid(posValue + 1);
+    QUuid macroId(macroName);
+    int count = 0;
+    foreach(graph::Vertex::Ptr vertex,processGraph->vertexList())
+    {
+      Macro::Ptr macro = vertex->dataRef().staticCast<Macro>();
+      if ((!macroId.isNull() && vertex->id() != macroId) || (macroId.isNull() && macro->getName() != macroName)) continue;
+      foreach(QVariant param,macro->parameters())
+      {
+        MacroParameter* parameter = param.value<MacroParameter*>();
+        if (parameter != 0 && parameter->getName() == paramName)
+        {
+          parameter->setValue(value);
+          ++count;
+        }
+      }
+    }
+    if (count == 0)
+    {
+      syslog::error(QString(tr("No parameter '%1' found for macro '%2'.")).arg(paramName).arg(macroName),tr("Parameters"));
+      return false;
+    }
+    return true;
+  }
+
+  int GraphRunner::run(int iterations)
+  {
+    QThread pgThread;
+    processGraphCtrl = new ProcessGraphCtrl(*processGraph);
+    // the first frame initializes the macros, each further frame applies them once
+    processGraphCtrl->setMaxFrames((iterations > 0) ? iterations + 1 : 0);
+    processGraphCtrl->moveToThread(&pgThread);
+    QUuid unlockId = processGraph->lockEditing();
+    QEventLoop loop;
+    QTimer stopTimer;
+    connect(&pgThread,SIGNAL(finished()),&loop,SLOT(quit()));
+    connect(&stopTimer,SIGNAL(timeout()),this,SLOT(checkStopRequest()));
+    stopTimer.start(100);
+    int errors = syslog::Logger::instance().getMessageCount(syslog::Logger::Error);
+    QElapsedTimer timer;
+    timer.start();
+    pgThread.start();
+    loop.exec();
+    runTime = timer.nsecsElapsed() / 1000;
+    stopTimer.stop();
+    delete processGraphCtrl;
+    processGraphCtrl = 0;
+    processGraph->unlockEditing(unlockId);
+    // deliver pending log messages of processing thread
+    QCoreApplication::processEvents();
+    return (syslog::Logger::instance().getMessageCount(syslog::Logger::Error) > errors) ? 1 : 0;
+  }
+
+  void GraphRunner::printStatistics()
+  {
+    QList<graph::Vertex::Ptr> vertices = processGraph->topologicalOrder().values();
+    QStringList names;
+    int nameWidth = 5;
+    foreach(graph::Vertex::Ptr vertex,vertices)
+    {
+      names.append(QString("%1 {%2}").arg(vertex->dataRef().staticCast<Macro>()->getName()).arg(vertex->id().toString().mid(1,8)));
+      nameWidth = qMax(nameWidth,names.last().length());
+    }
+    out << qSetFieldWidth(nameWidth) << Qt::left << "Macro" << qSetFieldWidth(12) << Qt::right << "Runs" << "Mean [ms]" << "Min [ms]"
+        << "p50 [ms]" << "p95 [ms]" << "p99 [ms]" << "Max [ms]" << "Total [ms]" << qSetFieldWidth(0) << Qt::endl;
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+    out.setRealNumberPrecision(3);
+    qint64 total = 0;
+    for(int i = 0; i < vertices.count(); ++i)
+    {
+      const LatencyHistogram& runTimes = vertices[i]->dataRef().staticCast<Macro>()->getRuntimeHistogram();
+      out << qSetFieldWidth(nameWidth) << Qt::left << names[i] << qSetFieldWidth(12) << Qt::right << runTimes.count()
+          << runTimes.mean() / 1000.0 << runTimes.min() / 1000.0 << runTimes.percentile(50.0) / 1000.0 << runTimes.percentile(95.0) / 1000.0
+          << runTimes.percentile(99.0) / 1000.0 << runTimes.max() / 1000.0 << runTimes.total() / 1000.0 << qSetFieldWidth(0) << Qt::endl;
+      total += runTimes.total();
+    }
+    out << Qt::endl << QString(tr("Wall time: %1 ms, accumulated macro time: %2 ms")).arg(runTime / 1000.0,0,'f',3).arg(total / 1000.0,0,'f',3) << Qt::endl;
+    processGraph->updateCriticalPath();
+    out << QString(tr("Critical path: %1 ms per frame, observed frame time: %2 ms")).arg(processGraph->criticalPath().length / 1000.0,0,'f',3)
+           .arg(processGraph->observedFrameTime() / 1000.0,0,'f',3) << Qt::endl;
+  }
+
+  void GraphRunner::requestStop()
+  {
+    stopRequested = 1;
+  }
+
+  void GraphRunner::printLogEntry(syslog::Logger::MsgType type, int /*countType*/, int countTotal)
+  {
+    if (countTotal <= 0) return;
+    const syslog::Logger::LogEntry& entry = syslog::Logger::instance().getMessage(countTotal - 1);
+    if (type == syslog::Logger::Information && !verbose) return;
+    err << '[' << QChar(entry.msgType) << "] " << entry.category << ": " << entry.message << Qt::endl;
+  }
+
+  void GraphRunner::checkStopRequest()
+  {
+    if (stopRequested && processGraphCtrl != 0)
+    {
+      stopRequested = 0;
+      QMetaObject::invokeMethod(processGraphCtrl,"stop",Qt::QueuedConnection);
+    }
+  }
+
+}
@@ -0,0 +1,82 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+#ifndef APPRUNNER_H
+#define APPRUNNER_H
+
+#include "appprocessgraph.h"
+#include "sysloglogger.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <csignal>
+
+namespace app
+{
+  class Macro;
+
+  // Loads macro libraries and one process graph without any GUI and executes the graph
+  // for a given number of frames or until it is stopped.
+  class GraphRunner : public QObject
+  {
+    Q_OBJECT
+    Q_DISABLE_COPY(GraphRunner)
+  public:
+    GraphRunner(QObject* parent = 0);
+    ~GraphRunner();
+
+    void loadLibraries(const QStringList& dirs);
+    bool loadGraph(const QString& fileName);
+    bool setParameter(const QString& assignment);
+
+    ProcessGraph& graph()
+    {
+      return *processGraph;
+    }
+
+    void setVerbose(bool enable)
+    {
+      verbose = enable;
+    }
+
+    int run(int iterations);
+    void printStatistics();
+
+    static void requestStop();
+
+  private slots:
+    void printLogEntry(syslog::Logger::MsgType type, int countType, int countTotal);
+    void checkStopRequest();
+
+  private:
+    static volatile std::sig_atomic_t stopRequested;
+
+    ProcessGraph*     processGraph;
+    ProcessGraphCtrl* processGraphCtrl;
+    QTextStream       out;
+    QTextStream       err;
+    qint64            runTime;
+    bool              verbose;
+  };
+
+}
+#endif // APPRUNNER_H
@@ -0,0 +1,111 @@
+#******************************************************************************************
+#   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+#   Copyright (C) 2015-2020  Lars Libuda
+#
+#   This file is part of Impresario.
+#
+#   Impresario is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Impresario is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+#   If not, see <http://www.gnu.org/licenses/>.
+#*****************************************************************************************
+QT += core gui widgets concurrent
+CONFIG += c++11 console
+CONFIG -= app_bundle
+TARGET = impresario-run
+TEMPLATE = app
+VERSION = 2.1.2
+QMAKE_TARGET_DESCRIPTION = "Command line runner for Impresario process graphs"
+QMAKE_TARGET_COPYRIGHT = "Copyright (C) 2015-2020  Lars Libuda"
+
+!include(../impresario_bin_path.pri) {
+  error(Failed to include impresario_bin_path.pri)
+}
+DESTDIR = $${IMPRESARIO_BIN_PATH}
+
+# Graph and application core are shared with the GUI application. Graphical items
+# of process graph editor are not compiled into the runner.
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x050F01 IMPRESARIO_HEADLESS
+
+win32 {
+  CONFIG(release, release|debug) {
+    LIBS += $$quote(-L../components/libavoid/release) -llibavoid
+  }
+  CONFIG(debug, release|debug) {
+    LIBS += $$quote(-L../components/libavoid/debug) -llibavoidd
+  }
+}
+
+unix {
+  # Starting with GCC version 9 the gold linker is used
+  GCC_VERSION = $${system( g++ -dumpversion )}
+  versionAtLeast(GCC_VERSION,9) {
+    QMAKE_LFLAGS = -fuse-ld=gold
+  }
+
+  CONFIG(release, release|debug) {
+    LIBS += $$quote(-L../components/libavoid) -lavoid
+  }
+  CONFIG(debug, release|debug) {
+    LIBS += $$quote(-L../components/libavoid) -lavoidd
+  }
+}
+
+IMPRESARIO_SRC = $${_PRO_FILE_PWD_}/../impresario
+
+INCLUDEPATH += $$quote($${IMPRESARIO_SRC})
+INCLUDEPATH += $$quote($${_PRO_FILE_PWD_}/../components/libavoid/source)
+
+SOURCES += main.cpp \
+    apprunner.cpp \
+    appbenchmark.cpp \
+    $${IMPRESARIO_SRC}/appbuildinfo.cpp \
+    $${IMPRESARIO_SRC}/appexecutor.cpp \
+    $${IMPRESARIO_SRC}/apphistogram.cpp \
+    $${IMPRESARIO_SRC}/apptrace.cpp \
+    $${IMPRESARIO_SRC}/appmacro.cpp \
+    $${IMPRESARIO_SRC}/appmacrolibrary.cpp \
+    $${IMPRESARIO_SRC}/appmacromanager.cpp \
+    $${IMPRESARIO_SRC}/appprocessgraph.cpp \
+    $${IMPRESARIO_SRC}/graphbinary.cpp \
+    $${IMPRESARIO_SRC}/graphdata.cpp \
+    $${IMPRESARIO_SRC}/grapheditor.cpp \
+    $${IMPRESARIO_SRC}/graphelements.cpp \
+    $${IMPRESARIO_SRC}/graphitems.cpp \
+    $${IMPRESARIO_SRC}/graphmain.cpp \
+    $${IMPRESARIO_SRC}/graphresources.cpp \
+    $${IMPRESARIO_SRC}/graphserializer.cpp \
+    $${IMPRESARIO_SRC}/stdconsoleinterface.cpp \
+    $${IMPRESARIO_SRC}/sysloglogger.cpp
+
+HEADERS += apprunner.h \
+    appbenchmark.h \
+    $${IMPRESARIO_SRC}/appbuildinfo.h \
+    $${IMPRESARIO_SRC}/appexecutor.h \
+    $${IMPRESARIO_SRC}/apphistogram.h \
+    $${IMPRESARIO_SRC}/apptrace.h \
+    $${IMPRESARIO_SRC}/appmacro.h \
+    $${IMPRESARIO_SRC}/appmacrolibrary.h \
+    $${IMPRESARIO_SRC}/appmacromanager.h \
+    $${IMPRESARIO_SRC}/appprocessgraph.h \
+    $${IMPRESARIO_SRC}/graphbinary.h \
+    $${IMPRESARIO_SRC}/graphdata.h \
+    $${IMPRESARIO_SRC}/graphdefines.h \
+    $${IMPRESARIO_SRC}/grapheditor.h \
+    $${IMPRESARIO_SRC}/graphelements.h \
+    $${IMPRESARIO_SRC}/graphitems.h \
+    $${IMPRESARIO_SRC}/graphmain.h \
+    $${IMPRESARIO_SRC}/graphresources.h \
+    $${IMPRESARIO_SRC}/graphserializer.h \
+    $${IMPRESARIO_SRC}/stdconsoleinterface.h \
+    $${IMPRESARIO_SRC}/sysloglogger.h \
+    $${IMPRESARIO_SRC}/version.h
@@ -0,0 +1,159 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+
+#include "apprunner.h"
+#include "appbenchmark.h"
+#include "appbuildinfo.h"
+#include "graphserializer.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <csignal>
+#include <QtGlobal>
+#if (QT_VERSION >= QT_VERSION_CHECK(5,15,0)) && defined(Q_OS_LINUX)
+  #include <regex>
+#endif
+
+static void onSignal(int /*signal*/)
+{
+  app::GraphRunner::requestStop();
+}
+
+int main(int argc, char *argv[])
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(5,15,0)) && defined(Q_OS_LINUX)
+  /* Same workaround as in the GUI application: prevents a segfault on Linux
+   * when any macro uses std::regex.
+   */
+  std::regex dummy("dummy");
+#endif
+
+  QCoreApplication a(argc,argv);
+  a.setApplicationName("Impresario");
+  a.setOrganizationName("Impresario");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(QCoreApplication::translate("main","Runs an Impresario process graph without graphical user interface."));
+  parser.addHelpOption();
+  parser.addPositionalArgument("graph",QCoreApplication::translate("main","Process graph file to run."));
+  QCommandLineOption optLibs(QStringList() << "l" << "libs",QCoreApplication::translate("main","Directory containing macro libraries. May be given several times."),"dir");
+  QCommandLineOption optFrames(QStringList() << "n" << "frames",QCoreApplication::translate("main","Number of iterations to run. 0 runs until interrupted (default)."),"count","0");
+  QCommandLineOption optParam(QStringList() << "p" << "param",QCoreApplication::translate("main","Overrides parameter of macro given by name or instance id. May be given several times."),"macro.param=value");
+  QCommandLineOption optPipelined("pipelined",QCoreApplication::translate("main","Run frames pipelined with given depth."),"depth");
+  QCommandLineOption optWorkers("workers",QCoreApplication::translate("main","Number of worker threads, 0 uses one per core."),"count");
+  QCommandLineOption optNoFusion("no-fusion",QCoreApplication::translate("main","Do not fuse linear chains of macros."));
+  QCommandLineOption optStats("stats",QCoreApplication::translate("main","Writes runtime statistics of all macros to file. Files ending with .json are written as JSON, all others as CSV."),"file");
+  QCommandLineOption optTrace("trace",QCoreApplication::translate("main","Records a timeline of the run and writes it to file in Chrome's trace event format."),"file");
+  QCommandLineOption optBenchmark("benchmark",QCoreApplication::translate("main","Runs the graph core benchmark on synthetic graphs instead of a process graph and writes the results to file. Files ending with .json are written as JSON, all others as CSV."),"file");
+  QCommandLineOption optBenchmarkMax("benchmark-max",QCoreApplication::translate("main","Largest number of vertices of the benchmark graphs (default 100000)."),"count","100000");
+  QCommandLineOption optBenchmarkMacro("benchmark-macro",QCoreApplication::translate("main","Times the calls of 'apply' of the given macro from the loaded libraries in benchmark mode. Meant for macros doing nothing, inputs are not connected. May be given several times."),"name");
+  QCommandLineOption optVerbose(QStringList() << "v" << "verbose",QCoreApplication::translate("main","Print informational log messages."));
+  parser.addOption(optLibs);
+  parser.addOption(optFrames);
+  parser.addOption(optParam);
+  parser.addOption(optPipelined);
+  parser.addOption(optWorkers);
+  parser.addOption(optNoFusion);
+  parser.addOption(optStats);
+  parser.addOption(optTrace);
+  parser.addOption(optBenchmark);
+  parser.addOption(optBenchmarkMax);
+  parser.addOption(optBenchmarkMacro);
+  parser.addOption(optVerbose);
+  parser.process(a);
+  if (parser.positionalArguments().count() != 1 && !parser.isSet(optBenchmark))
+  {
+    parser.showHelp(1);
+  }
+
+  // graphs are loaded without scene and graphical items
+  graph::Serializer::enableVisualization(false);
+
+  QStringList libDirs = parser.values(optLibs);
+  if (libDirs.isEmpty())
+  {
+    libDirs.append(QCoreApplication::applicationDirPath());
+  }
+  for(int i = 0; i < libDirs.count(); ++i)
+  {
+    libDirs[i] = QDir(libDirs[i]).absolutePath();
+  }
+
+  if (parser.isSet(optBenchmark))
+  {
+    app::GraphBenchmark benchmark;
+    benchmark.run(parser.value(optBenchmarkMax).toInt());
+    if (parser.isSet(optBenchmarkMacro))
+    {
+      app::GraphRunner runner;
+      runner.setVerbose(parser.isSet(optVerbose));
+      runner.loadLibraries(libDirs);
+      benchmark.runDispatch(parser.values(optBenchmarkMacro));
+    }
+    return benchmark.save(parser.value(optBenchmark)) ? 0 : 1;
+  }
+
+  int result = 1;
+  {
+    app::GraphRunner runner;
+    runner.setVerbose(parser.isSet(optVerbose));
+    runner.loadLibraries(libDirs);
+    if (runner.loadGraph(parser.positionalArguments().first()))
+    {
+      bool paramsValid = true;
+      foreach(QString assignment,parser.values(optParam))
+      {
+        paramsValid = runner.setParameter(assignment) && paramsValid;
+      }
+      if (parser.isSet(optPipelined))
+      {
+        runner.graph().setPipelined(true);
+        runner.graph().setPipelineDepth(parser.value(optPipelined).toInt());
+      }
+      if (parser.isSet(optWorkers))
+      {
+        runner.graph().setWorkerCount(parser.value(optWorkers).toInt());
+      }
+      if (parser.isSet(optNoFusion))
+      {
+        runner.graph().setFuseChains(false);
+      }
+      runner.graph().setTracing(parser.isSet(optTrace));
+      if (paramsValid)
+      {
+        std::signal(SIGINT,onSignal);
+        std::signal(SIGTERM,onSignal);
+        result = runner.run(parser.value(optFrames).toInt());
+        runner.printStatistics();
+        if (parser.isSet(optStats) && !runner.graph().saveRuntimeStatistics(parser.value(optStats)))
+        {
+          result = 1;
+        }
+        if (parser.isSet(optTrace) && !runner.graph().saveTrace(parser.value(optTrace)))
+        {
+          result = 1;
+        }
+      }
+    }
+  }
+  QCoreApplication::processEvents();
+  return result;
+}
@@ -4,4 +4,5 @@ SUBDIRS = components/libavoid \
           components/qtpropertybrowser
 
 CONFIG += ordered
-SUBDIRS += impresario
+SUBDIRS += impresario \
+           impresario-run
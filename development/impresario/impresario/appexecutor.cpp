@@ -0,0 +1,197 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+
+#include "appexecutor.h"
+#include <QThread>
+#include <QList>
+#include <QElapsedTimer>
+#include <QAtomicInteger>
+#include <QString>
+
+namespace app
+{
+  //-----------------------------------------------------------------------
+  // Class TaskExecutor::Worker
+  //-----------------------------------------------------------------------
+  class TaskExecutor::Worker : public QThread
+  {
+  public:
+    Worker(TaskExecutor& owner, int workerIndex) : QThread(0), executor(owner), index(workerIndex), mutex(), deque(), tasks(0), steals(0), idleNsecs(0)
+    {
+    }
+
+    TaskExecutor&          executor;
+    int                    index;
+    QMutex                 mutex;
+    QList<Task>            deque;
+    QAtomicInteger<qint64> tasks;
+    QAtomicInteger<qint64> steals;
+    QAtomicInteger<qint64> idleNsecs;
+
+  protected:
+    virtual void run()
+    {
+      executor.work(*this);
+    }
+  };
+
+  //-----------------------------------------------------------------------
+  // Class TaskExecutor
+  //-----------------------------------------------------------------------
+  thread_local TaskExecutor::Worker* TaskExecutor::currentWorker = 0;
+
+  TaskExecutor::TaskExecutor(int workerCount) : workers(), injectMutex(), injectQueue(), idleMutex(), wakeCondition(), pendingTasks(0), stopping(false)
+  {
+    if (workerCount <= 0)
+    {
+      workerCount = QThread::idealThreadCount();
+    }
+    if (workerCount <= 0)
+    {
+      workerCount = 1;
+    }
+    for(int i = 0; i < workerCount; ++i)
+    {
+      workers.append(new Worker(*this,i));
+      workers.last()->setObjectName(QString("Worker %1").arg(i + 1));
+    }
+    foreach(Worker* worker, workers)
+    {
+      worker->start();
+    }
+  }
+
+  TaskExecutor::~TaskExecutor()
+  {
+    // workers finish all pending tasks before they terminate
+    idleMutex.lock();
+    stopping = true;
+    wakeCondition.wakeAll();
+    idleMutex.unlock();
+    foreach(Worker* worker, workers)
+    {
+      worker->wait();
+      delete worker;
+    }
+    workers.clear();
+  }
+
+  void TaskExecutor::submit(const Task& task)
+  {
+    Worker* worker = currentWorker;
+    if (worker != 0 && &worker->executor == this)
+    {
+      QMutexLocker lock(&worker->mutex);
+      worker->deque.append(task);
+    }
+    else
+    {
+      QMutexLocker lock(&injectMutex);
+      injectQueue.enqueue(task);
+    }
+    pendingTasks.ref();
+    QMutexLocker lock(&idleMutex);
+    wakeCondition.wakeOne();
+  }
+
+  TaskExecutor::Statistics TaskExecutor::statistics() const
+  {
+    Statistics stats;
+    stats.workers = workers.size();
+    stats.tasks = 0;
+    stats.steals = 0;
+    stats.idleNsecs = 0;
+    foreach(Worker* worker, workers)
+    {
+      stats.tasks += worker->tasks.load();
+      stats.steals += worker->steals.load();
+      stats.idleNsecs += worker->idleNsecs.load();
+    }
+    return stats;
+  }
+
+  void TaskExecutor::work(Worker& worker)
+  {
+    currentWorker = &worker;
+    Task task;
+    forever
+    {
+      if (fetch(worker,task))
+      {
+        pendingTasks.deref();
+        task();
+        task = Task();
+        worker.tasks.fetchAndAddRelaxed(1);
+        continue;
+      }
+      QMutexLocker lock(&idleMutex);
+      if (pendingTasks.load() > 0)
+      {
+        continue;
+      }
+      if (stopping)
+      {
+        break;
+      }
+      QElapsedTimer timer;
+      timer.start();
+      wakeCondition.wait(&idleMutex);
+      worker.idleNsecs.fetchAndAddRelaxed(timer.nsecsElapsed());
+    }
+    currentWorker = 0;
+  }
+
+  bool TaskExecutor::fetch(Worker& worker, Task& task)
+  {
+    // newest task of own deque first
+    worker.mutex.lock();
+    if (!worker.deque.isEmpty())
+    {
+      task = worker.deque.takeLast();
+      worker.mutex.unlock();
+      return true;
+    }
+    worker.mutex.unlock();
+    // tasks submitted from outside of the pool
+    injectMutex.lock();
+    if (!injectQueue.isEmpty())
+    {
+      task = injectQueue.dequeue();
+      injectMutex.unlock();
+      return true;
+    }
+    injectMutex.unlock();
+    // steal oldest task from other workers
+    for(int i = 1; i < workers.size(); ++i)
+    {
+      Worker* victim = workers[(worker.index + i) % workers.size()];
+      QMutexLocker lock(&victim->mutex);
+      if (!victim->deque.isEmpty())
+      {
+        task = victim->deque.takeFirst();
+        worker.steals.fetchAndAddRelaxed(1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+}
@@ -0,0 +1,82 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+#ifndef APPEXECUTOR_H
+#define APPEXECUTOR_H
+
+#include <QVector>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <functional>
+
+namespace app
+{
+  // Thread pool owned by a single process graph. Each worker has a local deque. Tasks submitted
+  // by a worker go to its own deque and are taken back in LIFO order, so a successor macro usually
+  // runs on the thread which just produced its input. Idle workers take tasks submitted from other
+  // threads first and then steal the oldest tasks of other workers.
+  class TaskExecutor
+  {
+  public:
+    typedef std::function<void()> Task;
+
+    struct Statistics
+    {
+      int    workers;
+      qint64 tasks;
+      qint64 steals;
+      qint64 idleNsecs;
+    };
+
+    explicit TaskExecutor(int workerCount = 0);
+    ~TaskExecutor();
+
+    int workerCount() const
+    {
+      return workers.size();
+    }
+
+    void submit(const Task& task);
+    Statistics statistics() const;
+
+  private:
+    Q_DISABLE_COPY(TaskExecutor)
+
+    class Worker;
+    friend class Worker;
+
+    void work(Worker& worker);
+    bool fetch(Worker& worker, Task& task);
+
+    static thread_local Worker* currentWorker;
+
+    QVector<Worker*> workers;
+    QMutex           injectMutex;
+    QQueue<Task>     injectQueue;
+    QMutex           idleMutex;
+    QWaitCondition   wakeCondition;
+    QAtomicInt       pendingTasks;
+    bool             stopping;
+  };
+
+}
+#endif // APPEXECUTOR_H
@@ -0,0 +1,119 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+
+#include "apphistogram.h"
+#include <QtAlgorithms>
+#include <limits>
+#include <cmath>
+
+namespace app
+{
+  LatencyHistogram::LatencyHistogram() : buckets(), valueCount(0), valueSum(0), valueMin(std::numeric_limits<qint64>::max()), valueMax(0)
+  {
+  }
+
+  void LatencyHistogram::record(qint64 musecs)
+  {
+    if (musecs < 0) musecs = 0;
+    buckets[bucketIndex(static_cast<quint64>(musecs))].fetchAndAddRelaxed(1);
+    valueSum.fetchAndAddRelaxed(musecs);
+    qint64 current = valueMin.loadRelaxed();
+    while(musecs < current && !valueMin.testAndSetRelaxed(current,musecs,current));
+    current = valueMax.loadRelaxed();
+    while(musecs > current && !valueMax.testAndSetRelaxed(current,musecs,current));
+    // count is published last, so readers never see more values than are in the buckets
+    valueCount.fetchAndAddRelease(1);
+  }
+
+  void LatencyHistogram::reset()
+  {
+    valueCount.storeRelease(0);
+    for(int i = 0; i < BucketCount; ++i)
+    {
+      buckets[i].storeRelaxed(0);
+    }
+    valueSum.storeRelaxed(0);
+    valueMin.storeRelaxed(std::numeric_limits<qint64>::max());
+    valueMax.storeRelaxed(0);
+  }
+
+  qint64 LatencyHistogram::min() const
+  {
+    return (count() > 0) ? valueMin.loadRelaxed() : 0;
+  }
+
+  qint64 LatencyHistogram::max() const
+  {
+    return (count() > 0) ? valueMax.loadRelaxed() : 0;
+  }
+
+  double LatencyHistogram::mean() const
+  {
+    qint64 n = count();
+    return (n > 0) ? static_cast<double>(total()) / n : 0.0;
+  }
+
+  qint64 LatencyHistogram::percentile(double percent) const
+  {
+    qint64 n = count();
+    if (n <= 0) return 0;
+    qint64 rank = qMax(qint64(1),static_cast<qint64>(std::ceil(qBound(0.0,percent,100.0) / 100.0 * n)));
+    qint64 seen = 0;
+    for(int i = 0; i < BucketCount; ++i)
+    {
+      seen += buckets[i].loadRelaxed();
+      if (seen >= rank)
+      {
+        // report the middle of the bucket, but never leave the range of observed values
+        qint64 value = static_cast<qint64>(bucketLowerBound(i) + bucketWidth(i) / 2);
+        return qBound(min(),value,max());
+      }
+    }
+    return max();
+  }
+
+  QString LatencyHistogram::toString(qint64 musecs)
+  {
+    return QString("%1 ms").arg(musecs / 1000.0,0,'f',3);
+  }
+
+  int LatencyHistogram::bucketIndex(quint64 value)
+  {
+    if (value < SubBuckets) return static_cast<int>(value);
+    int msb = 63 - qCountLeadingZeroBits(value);
+    int shift = msb - SubBucketBits;
+    return (shift + 1) * SubBuckets + static_cast<int>((value >> shift) & (SubBuckets - 1));
+  }
+
+  quint64 LatencyHistogram::bucketLowerBound(int index)
+  {
+    if (index < SubBuckets) return static_cast<quint64>(index);
+    int shift = index / SubBuckets - 1;
+    return static_cast<quint64>(SubBuckets + index % SubBuckets) << shift;
+  }
+
+  quint64 LatencyHistogram::bucketWidth(int index)
+  {
+    if (index < SubBuckets) return 1;
+    return quint64(1) << (index / SubBuckets - 1);
+  }
+
+}
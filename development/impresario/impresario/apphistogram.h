@@ -0,0 +1,80 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+#ifndef APPHISTOGRAM_H
+#define APPHISTOGRAM_H
+
+#include <QAtomicInteger>
+#include <QString>
+
+namespace app
+{
+  // Histogram of macro runtimes in micro seconds. Values below 16 are counted exactly, larger values
+  // fall into 16 linear sub-buckets per power of two, so each bucket is at most 1/16 of its lower
+  // bound wide. All counters are atomic, hence record() may be called from any worker thread without
+  // locking while the GUI reads the statistics.
+  class LatencyHistogram
+  {
+  public:
+    LatencyHistogram();
+
+    void record(qint64 musecs);
+    void reset();
+
+    qint64 count() const
+    {
+      return valueCount.loadAcquire();
+    }
+
+    qint64 total() const
+    {
+      return valueSum.loadAcquire();
+    }
+
+    qint64 min() const;
+    qint64 max() const;
+    double mean() const;
+    qint64 percentile(double percent) const;
+
+    static QString toString(qint64 musecs);
+
+  private:
+    Q_DISABLE_COPY(LatencyHistogram)
+
+    enum
+    {
+      SubBucketBits = 4,
+      SubBuckets = 1 << SubBucketBits,
+      BucketCount = (64 - SubBucketBits) * SubBuckets
+    };
+
+    static int bucketIndex(quint64 value);
+    static quint64 bucketLowerBound(int index);
+    static quint64 bucketWidth(int index);
+
+    QAtomicInteger<quint32> buckets[BucketCount];
+    QAtomicInteger<qint64>  valueCount;
+    QAtomicInteger<qint64>  valueSum;
+    QAtomicInteger<qint64>  valueMin;
+    QAtomicInteger<qint64>  valueMax;
+  };
+
+}
+#endif // APPHISTOGRAM_H
@@ -31,6 +31,7 @@
 #include <QClipboard>
 #include <QRegularExpression>
 #include <QLibraryInfo>
+#include <QStandardPaths>
 
 namespace app
 {
@@ -218,6 +219,11 @@ namespace app
   void Impresario::initMacroLibraries()
   {
     QStringList dirs = Resource::getPaths(Resource::SETTINGS_PATH_MACROS);
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheDir.isEmpty() && QDir().mkpath(cacheDir))
+    {
+      MacroManager::instance().setManifestCache(cacheDir + "/macros.cache");
+    }
     MacroManager::instance().loadPrototypes(dirs);
   }
 
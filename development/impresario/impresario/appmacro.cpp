@@ -21,7 +21,9 @@
 
 #include "appmacro.h"
 #include "appmacromanager.h"
+#ifndef IMPRESARIO_HEADLESS
 #include "pgeitems.h"
+#endif
 #include "sysloglogger.h"
 #include <QMetaProperty>
 #include <QCoreApplication>
@@ -55,8 +57,8 @@ namespace app
   //-----------------------------------------------------------------------
   // Class MacroPin
   //-----------------------------------------------------------------------
-  MacroPin::MacroPin(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, void* itemData, graph::Defines::PinDirectionType direction) : graph::PinData(itemName + ": " + itemType,direction),
-    dataPtr(itemData), macroRef(macro), description(itemDescr), type(itemType), pinName(itemName)
+  MacroPin::MacroPin(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, quint64 itemTypeId, void* itemData, graph::Defines::PinDirectionType direction) : graph::PinData(itemName + ": " + itemType,direction),
+    dataPtr(itemData), macroRef(macro), description(itemDescr), type(itemType), typeId(itemTypeId), pinName(itemName)
   {
     setPropertyStartIndex(app::MacroPin::staticMetaObject.propertyOffset());
   }
@@ -68,18 +70,24 @@ namespace app
   bool MacroPin::allowConnectionTo(const PinData& other) const
   {
     const MacroPin& otherPin = static_cast<const MacroPin&>(other);
-    return &macroRef != &(otherPin.macroRef) && type == otherPin.type;
+    return &macroRef != &(otherPin.macroRef) && typeId == otherPin.typeId;
   }
 
   QSharedPointer<graph::BaseItem> MacroPin::createVisualization(graph::BaseElement& elementRef, graph::BaseItem* parent)
   {
+#ifndef IMPRESARIO_HEADLESS
     return QSharedPointer<graph::BaseItem>(new pge::MacroPinItem(static_cast<graph::Pin&>(elementRef),parent));
+#else
+    Q_UNUSED(elementRef)
+    Q_UNUSED(parent)
+    return QSharedPointer<graph::BaseItem>();
+#endif
   }
 
   //-----------------------------------------------------------------------
   // Class MacroInput
   //-----------------------------------------------------------------------
-  MacroInput::MacroInput(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, void* itemData) : MacroPin(macro,itemName,itemDescr,itemType,itemData,graph::Defines::Incoming)
+  MacroInput::MacroInput(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, quint64 itemTypeId, void* itemData) : MacroPin(macro,itemName,itemDescr,itemType,itemTypeId,itemData,graph::Defines::Incoming)
   {
   }
 
@@ -90,8 +98,13 @@ namespace app
   //-----------------------------------------------------------------------
   // Class MacroOutput
   //-----------------------------------------------------------------------
-  MacroOutput::MacroOutput(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, void* itemData) : MacroPin(macro,itemName,itemDescr,itemType,itemData,graph::Defines::Outgoing)
+  MacroOutput::MacroOutput(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, quint64 itemTypeId, void* itemData, const QVector<void*>& itemSlots) : MacroPin(macro,itemName,itemDescr,itemType,itemTypeId,itemData,graph::Defines::Outgoing),
+    slotPtrs(itemSlots)
   {
+    if (slotPtrs.isEmpty())
+    {
+      slotPtrs.append(itemData);
+    }
   }
 
   MacroOutput::~MacroOutput()
@@ -109,7 +122,13 @@ namespace app
 
   QSharedPointer<graph::BaseItem> MacroLink::createVisualization(graph::BaseElement& elementRef, graph::BaseItem* parent)
   {
+#ifndef IMPRESARIO_HEADLESS
     return QSharedPointer<graph::BaseItem>(new pge::MacroLinkItem(static_cast<graph::Edge&>(elementRef),parent));
+#else
+    Q_UNUSED(elementRef)
+    Q_UNUSED(parent)
+    return QSharedPointer<graph::BaseItem>();
+#endif
   }
 
   void MacroLink::elementStatusUpdated(graph::BaseElement &element, int change)
@@ -144,7 +163,7 @@ namespace app
   // Class Macro
   //-----------------------------------------------------------------------
   Macro::Macro(const MacroLibrary& lib) : graph::VertexData(), library(lib), name(), creator(), group(), description(), errorMsg(), propertyWidgetComponent(),
-    macroClass(), type(Undefined), params(), prototype(0), mutex(QMutex::Recursive), runTime(0), state(Idle), viewers()
+    macroClass(), type(Undefined), params(), prototype(0), mutex(QMutex::Recursive), runTime(0), runTimes(), state(Idle), viewers()
   {
     // Initially, prototype macros are loaded in separate thread. The following makes sure, that all macro instances live in the application's main thread
     moveToThread(QCoreApplication::instance()->thread());
@@ -217,6 +236,56 @@ namespace app
     return true;
   }
 
+  void Macro::save(graph::BinaryWriter& stream) const
+  {
+    writeElementStart(stream);
+    writeProperties(stream);
+
+    stream.writeUInt32(params.count());
+    foreach(QVariant variant, params)
+    {
+      MacroParameter* param = variant.value<MacroParameter*>();
+      stream.writeString(param->getName());
+      stream.writeString(param->getType());
+      stream.writeString(param->getValue().toString());
+    }
+
+    writeElementEnd(stream);
+  }
+
+  bool Macro::load(graph::BinaryReader &stream)
+  {
+    if (!readElementStart(stream)) return false;
+    if (!readProperties(stream)) return false;
+    // build internal map
+    QMap<QString, MacroParameter*> paramMap;
+    foreach(QVariant paramVariant,params)
+    {
+      MacroParameter* param = paramVariant.value<MacroParameter*>();
+      paramMap.insert(param->getName() + param->getType(),param);
+    }
+    // read parameters
+    quint32 count = stream.readUInt32();
+    for(quint32 i = 0; i < count && !stream.hasError(); ++i)
+    {
+      QString paramName = stream.readString();
+      QString paramType = stream.readString();
+      QString paramValue = stream.readString();
+      if (stream.hasError()) return false;
+      if (paramMap.contains(paramName + paramType))
+      {
+        paramMap[paramName + paramType]->setValue(QVariant(paramValue));
+      }
+      else
+      {
+        QString filename = stream.fileName().split('/').last();
+        syslog::warning(QString(tr("%5: Parameter '%1' of type '%2' is not supported by macro '%3' with signature '%4'. Ignored.")).arg(paramName).arg(paramType).arg(getName()).arg(getTypeSignature()).arg(filename),tr("Process Graph"));
+      }
+    }
+    if (!readElementEnd(stream)) return false;
+    return true;
+  }
+
   bool Macro::registerViewer(QSharedPointer<MacroViewer> viewer)
   {
     if (!viewer.isNull())
@@ -266,15 +335,20 @@ namespace app
   //-----------------------------------------------------------------------
   // Class MacroDLL
   //-----------------------------------------------------------------------
-  MacroDLL::MacroDLL(const MacroLibraryDLL& lib, const MacroLibraryDLL::MacroHandle& handle) : Macro(lib), macroHandle(handle)
+  MacroDLL::MacroDLL(const MacroLibraryDLL& lib, const MacroLibraryDLL::MacroHandle& handle) : MacroDLL(lib,handle,lib.describeMacro(handle))
+  {
+  }
+
+  MacroDLL::MacroDLL(const MacroLibraryDLL& lib, const MacroLibraryDLL::MacroHandle& handle, const MacroLibraryDLL::MacroInfo& info) : Macro(lib),
+    macroHandle(handle), macroIndex(info.index), paramValueTypes(), slotRing(false), currentFrame(0)
   {
     // fill general attributes
-    name = lib.getMacroName(macroHandle);
-    creator = lib.getMacroCreator(macroHandle);
-    group = lib.getMacroGroup(macroHandle);
-    description = lib.getMacroDescription(macroHandle);
-    propertyWidgetComponent = lib.getMacroPropertyWidgetComponent(macroHandle);
-    switch(lib.getMacroType(macroHandle))
+    name = info.name;
+    creator = info.creator;
+    group = info.group;
+    description = info.description;
+    propertyWidgetComponent = info.propertyWidgetComponent;
+    switch(info.type)
     {
       case 0:
         macroClass = tr("Macro");
@@ -292,49 +366,28 @@ namespace app
     setSignature(name + '_' + lib.getName() + '_' + lib.getVersionString() + '_' +
                  QString("%1").arg(lib.getCompilerVersion()) + ((lib.isDebugVersion()) ? "d" : "r"));
     // create macro inputs
-    unsigned int count = 0;
-    MacroLibraryDLL::DataDescriptor* dataDescr = lib.getMacroInputs(macroHandle,count);
-    while(dataDescr)
+    foreach(const MacroLibraryDLL::PinInfo& pin, info.inputs)
     {
-      QString itemName = QString::fromWCharArray(dataDescr->name);
-      QString itemDescription = QString::fromWCharArray(dataDescr->description);
-      QString itemType = QString::fromLatin1(dataDescr->type);
-      graph::PinData::Ptr item = graph::PinData::Ptr(new MacroInput(*this,itemName,itemDescription,itemType,dataDescr->valuePtr));
+      graph::PinData::Ptr item = graph::PinData::Ptr(new MacroInput(*this,pin.name,pin.description,pin.type,pin.typeId,pin.valuePtr));
       addPinData(item);
-      dataDescr = dataDescr->next;
     }
     // create macro outputs
-    count = 0;
-    dataDescr = lib.getMacroOutputs(macroHandle,count);
-    while(dataDescr)
-    {
-      QString itemName = QString::fromWCharArray(dataDescr->name);
-      QString itemDescription = QString::fromWCharArray(dataDescr->description);
-      QString itemType = QString::fromLatin1(dataDescr->type);
-      graph::PinData::Ptr item = graph::PinData::Ptr(new MacroOutput(*this,itemName,itemDescription,itemType,dataDescr->valuePtr));
+    foreach(const MacroLibraryDLL::PinInfo& pin, info.outputs)
+    {
+      slotRing = slotRing || pin.outputSlots.size() > 1;
+      graph::PinData::Ptr item = graph::PinData::Ptr(new MacroOutput(*this,pin.name,pin.description,pin.type,pin.typeId,pin.valuePtr,pin.outputSlots));
       addPinData(item);
-      dataDescr = dataDescr->next;
     }
     // create macro parameters
-    dataDescr = lib.getMacroParameters(macroHandle,count);
-    count = 0;
-    while(dataDescr)
-    {
-      QString itemName = QString::fromWCharArray(dataDescr->name);
-      QString itemDescription = QString::fromWCharArray(dataDescr->description);
-      QString itemType = QString::fromLatin1(dataDescr->type);
-      QString itemConfig;
-      if (dataDescr->valuePtr != 0)
-      {
-        itemConfig = QString::fromWCharArray(reinterpret_cast<const wchar_t*>(dataDescr->valuePtr));
-      }
-      MacroParameter* item = new MacroParameter(*this,itemName,itemDescription,itemType,itemConfig,count);
-      QString itemValue = lib.getMacroParameter(macroHandle,count++);
-      QVariant value(itemValue);
+    unsigned int count = 0;
+    foreach(const MacroLibraryDLL::ParameterInfo& param, info.parameters)
+    {
+      MacroParameter* item = new MacroParameter(*this,param.name,param.description,param.type,param.config,count++);
+      paramValueTypes.append(param.valueType);
+      QVariant value(param.value);
       item->setDefaultValue(value);
       params.append(QVariant::fromValue(item));
       connect(item,SIGNAL(valueChangedByUser()),this,SLOT(parameterChangedByUser()));
-      dataDescr = dataDescr->next;
     }
   }
 
@@ -346,13 +399,31 @@ namespace app
       prototype = 0;
     }
     const MacroLibraryDLL& lib = static_cast<const MacroLibraryDLL&>(library);
-    lib.deleteMacro(macroHandle);
+    if (macroHandle != 0)
+    {
+      lib.deleteMacro(macroHandle);
+    }
+  }
+
+  MacroLibraryDLL::MacroHandle MacroDLL::cloneHandle()
+  {
+    const MacroLibraryDLL& lib = static_cast<const MacroLibraryDLL&>(library);
+    if (macroHandle == 0)
+    {
+      // prototype restored from the manifest cache -> load its library now
+      macroHandle = lib.loadMacroHandle(macroIndex);
+      if (macroHandle == 0)
+      {
+        return 0;
+      }
+    }
+    return lib.cloneMacro(macroHandle);
   }
 
   graph::VertexData::Ptr MacroDLL::clone()
   {
     const MacroLibraryDLL& lib = static_cast<const MacroLibraryDLL&>(library);
-    const MacroLibraryDLL::MacroHandle handle = lib.cloneMacro(this->macroHandle);
+    const MacroLibraryDLL::MacroHandle handle = cloneHandle();
     if (!handle)
     {
       return graph::VertexData::Ptr();
@@ -371,13 +442,31 @@ namespace app
 
   QSharedPointer<graph::BaseItem> MacroDLL::createVisualization(graph::BaseElement& elementRef, graph::BaseItem* parent)
   {
+#ifndef IMPRESARIO_HEADLESS
     return QSharedPointer<graph::BaseItem>(new pge::MacroItem(static_cast<graph::Vertex&>(elementRef),parent));
+#else
+    Q_UNUSED(elementRef)
+    Q_UNUSED(parent)
+    return QSharedPointer<graph::BaseItem>();
+#endif
+  }
+
+  void MacroDLL::selectFrame(int frame)
+  {
+    currentFrame = frame;
+    // only libraries with a ring of output slots need to know the frame
+    if (slotRing)
+    {
+      const MacroLibraryDLL& lib = static_cast<const MacroLibraryDLL&>(library);
+      lib.selectMacroOutputSlots(macroHandle,static_cast<unsigned int>(frame));
+    }
   }
 
   int MacroDLL::start()
   {
     const MacroLibraryDLL& lib = static_cast<const MacroLibraryDLL&>(library);
     int result = lib.startMacro(macroHandle);
+    runTimes.reset();
     mutex.lock();
     if (result > 1)
     {
@@ -403,6 +492,7 @@ namespace app
     time.start();
     int result = lib.applyMacro(macroHandle);
     runTime = time.nsecsElapsed() / 1000; // runtime in micro seconds
+    runTimes.record(runTime);
     mutex.lock();
     if (result > 1)
     {
@@ -412,6 +502,7 @@ namespace app
     {
       for(ViewerSet::iterator it = viewers.begin(); it != viewers.end(); ++it)
       {
+        (*it)->selectFrame(currentFrame);
         if ((*it)->apply() > 1)
         {
           errorMsg = QString(tr("Attached viewer '%1': %2").arg((*it)->getName())).arg((*it)->getErrorMsg());
@@ -483,8 +574,12 @@ namespace app
       if (param)
       {
         const MacroLibraryDLL& lib = static_cast<const MacroLibraryDLL&>(library);
+        QString value;
         mutex.lock();
-        QString value = lib.getMacroParameter(macroHandle,parameterIndex);
+        if (!lib.getMacroParameterData(macroHandle,parameterIndex,paramValueTypes.value(parameterIndex),value))
+        {
+          value = lib.getMacroParameter(macroHandle,parameterIndex);
+        }
         mutex.unlock();
         param->updateValueByMacro(QVariant(value));
         emit parameterUpdated(param->getIndex());
@@ -495,11 +590,16 @@ namespace app
   void MacroDLL::parameterChangedByUser()
   {
     MacroParameter* param = qobject_cast<MacroParameter*>(QObject::sender());
-    if (param != 0)
+    if (param != 0 && macroHandle != 0)
     {
       const MacroLibraryDLL& lib = static_cast<const MacroLibraryDLL&>(library);
+      QVariant value = param->getValue();
       mutex.lock();
-      lib.setMacroParameter(macroHandle,param->getIndex(),param->getValue().toString());
+      // parameters with a raw representation are passed without string conversion
+      if (!lib.setMacroParameterData(macroHandle,param->getIndex(),paramValueTypes.value(param->getIndex()),value))
+      {
+        lib.setMacroParameter(macroHandle,param->getIndex(),value.toString());
+      }
       mutex.unlock();
     }
   }
@@ -507,7 +607,12 @@ namespace app
   //-----------------------------------------------------------------------
   // Class MacroViewer
   //-----------------------------------------------------------------------
-  MacroViewer::MacroViewer(const MacroLibraryDLL &lib, const MacroLibraryDLL::MacroHandle &handle) : MacroDLL(lib,handle), dataTypeMap()
+  MacroViewer::MacroViewer(const MacroLibraryDLL &lib, const MacroLibraryDLL::MacroHandle &handle) : MacroViewer(lib,handle,lib.describeMacro(handle))
+  {
+  }
+
+  MacroViewer::MacroViewer(const MacroLibraryDLL &lib, const MacroLibraryDLL::MacroHandle &handle, const MacroLibraryDLL::MacroInfo &info) : MacroDLL(lib,handle,info),
+    dataTypeMap(), dataSource(), dataSink()
   {
     const graph::VertexData::PinDataMap& pins = pinData();
     for(graph::VertexData::PinDataMap::const_iterator it = pins.begin(); it != pins.end(); ++it)
@@ -515,7 +620,7 @@ namespace app
       if (it.value()->direction() == graph::Defines::Incoming)
       {
         MacroInput::Ptr input = it.value().staticCast<MacroInput>();
-        dataTypeMap.insert(input->getType(),input.toWeakRef());
+        dataTypeMap.insert(input->getTypeId(),input.toWeakRef());
       }
     }
   }
@@ -527,7 +632,7 @@ namespace app
   graph::VertexData::Ptr MacroViewer::clone()
   {
     const MacroLibraryDLL& lib = static_cast<const MacroLibraryDLL&>(library);
-    const MacroLibraryDLL::MacroHandle handle = lib.cloneMacro(this->macroHandle);
+    const MacroLibraryDLL::MacroHandle handle = cloneHandle();
     if (!handle)
     {
       return graph::VertexData::Ptr();
@@ -550,11 +655,13 @@ namespace app
 
   bool MacroViewer::setData(MacroOutput::Ptr data)
   {
-    if (!data.isNull() && dataTypeMap.contains(data->getType()))
+    if (!data.isNull() && dataTypeMap.contains(data->getTypeId()))
     {
-      MacroInput::Ptr inputRef = dataTypeMap[data->getType()];
+      MacroInput::Ptr inputRef = dataTypeMap.value(data->getTypeId());
       if (!inputRef.isNull())
       {
+        dataSource = data.toWeakRef();
+        dataSink = inputRef.toWeakRef();
         return inputRef->setDataPtr(*data.data());
       }
       else
@@ -568,6 +675,17 @@ namespace app
     }
   }
 
+  void MacroViewer::selectFrame(int frame)
+  {
+    // show the slot of the data source written in the given frame
+    MacroOutput::Ptr source = dataSource.toStrongRef();
+    MacroInput::Ptr sink = dataSink.toStrongRef();
+    if (!source.isNull() && !sink.isNull() && source->getSlotCount() > 1)
+    {
+      sink->setDataPtr(*source.data(),frame);
+    }
+  }
+
   int MacroViewer::start()
   {
     const MacroLibraryDLL& lib = static_cast<const MacroLibraryDLL&>(library);
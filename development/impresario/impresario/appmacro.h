@@ -24,6 +24,7 @@
 #include "graphdata.h"
 #include "graphelements.h"
 #include "appmacrolibrary.h"
+#include "apphistogram.h"
 #include <QString>
 #include <QTime>
 #include <QSharedPointer>
@@ -32,7 +33,9 @@
 #include <QVariant>
 #include <QVariantList>
 #include <QMap>
+#include <QHash>
 #include <QList>
+#include <QVector>
 #include <QSet>
 #include <QWidget>
 
@@ -166,6 +169,11 @@ namespace app
       return type;
     }
 
+    quint64 getTypeId() const
+    {
+      return typeId;
+    }
+
     void* getDataPtr() const
     {
       return dataPtr;
@@ -181,7 +189,7 @@ namespace app
 
   protected:
     Q_DISABLE_COPY(MacroPin)
-    MacroPin(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, void* itemData, graph::Defines::PinDirectionType direction);
+    MacroPin(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, quint64 itemTypeId, void* itemData, graph::Defines::PinDirectionType direction);
 
     void* dataPtr;
 
@@ -189,6 +197,7 @@ namespace app
     const Macro& macroRef;
     QString      description;
     QString      type;
+    quint64      typeId;
     QString      pinName;
   };
 
@@ -200,8 +209,21 @@ namespace app
   public:
     typedef QSharedPointer<MacroOutput> Ptr;
 
-    MacroOutput(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, void* itemData);
+    MacroOutput(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, quint64 itemTypeId, void* itemData, const QVector<void*>& itemSlots = QVector<void*>());
     ~MacroOutput();
+
+    int getSlotCount() const
+    {
+      return slotPtrs.size();
+    }
+
+    void* getSlotPtr(int frame) const
+    {
+      return slotPtrs.at(frame % slotPtrs.size());
+    }
+
+  private:
+    QVector<void*> slotPtrs;
   };
 
   class MacroInput : public MacroPin
@@ -212,18 +234,18 @@ namespace app
   public:
     typedef QSharedPointer<MacroInput> Ptr;
 
-    MacroInput(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, void* itemData);
+    MacroInput(const Macro& macro, const QString& itemName, const QString& itemDescr, const QString& itemType, quint64 itemTypeId, void* itemData);
     ~MacroInput();
 
-    bool setDataPtr(const MacroOutput& output)
+    bool setDataPtr(const MacroOutput& output, int frame = 0)
     {
-      if (output.getType() != this->getType())
+      if (output.getTypeId() != this->getTypeId())
       {
         Q_ASSERT(false);
         return false;
       }
       void** ppData = reinterpret_cast<void**>(dataPtr);
-      *ppData = output.getDataPtr();
+      *ppData = output.getSlotPtr(frame);
       return true;
     }
 
@@ -338,6 +360,11 @@ namespace app
 
     QString getRuntimeString() const;
 
+    const LatencyHistogram& getRuntimeHistogram() const
+    {
+      return runTimes;
+    }
+
     enum MacroState
     {
       Idle,
@@ -357,6 +384,10 @@ namespace app
       return params;
     }
 
+    virtual void selectFrame(int /*frame*/)
+    {
+    }
+
     virtual int start() = 0;
     virtual int apply() = 0;
     virtual int stop() = 0;
@@ -364,6 +395,8 @@ namespace app
     virtual void destroyWidget() = 0;
     virtual void save(QXmlStreamWriter &stream) const;
     virtual bool load(QXmlStreamReader &stream);
+    virtual void save(graph::BinaryWriter &stream) const;
+    virtual bool load(graph::BinaryReader &stream);
 
     bool registerViewer(QSharedPointer<MacroViewer> viewer);
     bool unregisterViewer(QSharedPointer<MacroViewer> viewer);
@@ -412,6 +445,7 @@ namespace app
     // thread safe attributes for all types of macros
     mutable QMutex      mutex;
     qint64              runTime;
+    LatencyHistogram    runTimes;
     MacroState          state;
     ViewerSet           viewers;
   };
@@ -423,6 +457,7 @@ namespace app
     Q_DISABLE_COPY(MacroDLL)
   public:
     virtual ~MacroDLL();
+    virtual void selectFrame(int frame);
     virtual int start();
     virtual int apply();
     virtual int stop();
@@ -438,8 +473,15 @@ namespace app
 
   protected:
     MacroDLL(const MacroLibraryDLL& lib, const MacroLibraryDLL::MacroHandle& handle);
+    MacroDLL(const MacroLibraryDLL& lib, const MacroLibraryDLL::MacroHandle& handle, const MacroLibraryDLL::MacroInfo& info);
+
+    MacroLibraryDLL::MacroHandle cloneHandle();
 
     MacroLibraryDLL::MacroHandle macroHandle;
+    unsigned int                 macroIndex;
+    QVector<unsigned int>        paramValueTypes;
+    bool                         slotRing;
+    int                          currentFrame;
   };
 
   class MacroViewer : public MacroDLL
@@ -451,6 +493,7 @@ namespace app
     typedef QSharedPointer<MacroViewer> Ptr;
 
     virtual ~MacroViewer();
+    virtual void selectFrame(int frame);
     virtual int start();
     virtual int apply();
     virtual int stop();
@@ -458,6 +501,16 @@ namespace app
     virtual QSharedPointer<graph::BaseItem> createVisualization(graph::BaseElement& elementRef, graph::BaseItem* parent = 0);
 
     QList<QString> dataTypes() const
+    {
+      QList<QString> types;
+      foreach(MacroInput::Ptr input, dataTypeMap)
+      {
+        types.append(input->getType());
+      }
+      return types;
+    }
+
+    QList<quint64> dataTypeIds() const
     {
       return dataTypeMap.keys();
     }
@@ -466,10 +519,13 @@ namespace app
 
   private:
     MacroViewer(const MacroLibraryDLL& lib, const MacroLibraryDLL::MacroHandle& handle);
+    MacroViewer(const MacroLibraryDLL& lib, const MacroLibraryDLL::MacroHandle& handle, const MacroLibraryDLL::MacroInfo& info);
 
-    typedef QMap<QString,MacroInput::Ptr> DataTypeMap;
+    typedef QHash<quint64,MacroInput::Ptr> DataTypeMap;
 
-    DataTypeMap dataTypeMap;
+    DataTypeMap                dataTypeMap;
+    QWeakPointer<MacroOutput>  dataSource;
+    QWeakPointer<MacroInput>   dataSink;
   };
 
 }
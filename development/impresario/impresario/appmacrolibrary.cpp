@@ -28,6 +28,9 @@
 #include <QObject>
 #include <QDir>
 #include <QFileInfo>
+#include <QDataStream>
+#include <QMutexLocker>
+#include <QLocale>
 
 namespace app
 {
@@ -51,116 +54,152 @@ namespace app
   //-----------------------------------------------------------------------
   // Class MacroLibraryDLL
   //-----------------------------------------------------------------------
-  const QString MacroLibraryDLL::InterfaceFunctionNames[] = {
-    "libGetBuildDate",
-    "libGetCompiler",
-    "libGetCompilerId",
-    "libGetQtVersion",
-    "libIsDebugVersion",
-    "libGetName",
-    "libGetVersion",
-    "libGetAPIVersion",
-    "libGetCreator",
-    "libGetDescription",
-    "libInitialize",
-    "libTerminate",
-    "macroClone",
-    "macroDelete",
-    "macroGetType",
-    "macroGetName",
-    "macroGetCreator",
-    "macroGetGroup",
-    "macroGetDescription",
-    "macroGetErrorMsg",
-    "macroGetPropertyWidgetComponent",
-    "macroGetInputs",
-    "macroGetOutputs",
-    "macroGetParameters",
-    "macroStart",
-    "macroApply",
-    "macroStop",
-    "macroSetParameterValue",
-    "macroGetParameterValue",
-    "macroSetImpresarioDataPtr",
-    "macroGetImpresarioDataPtr",
-    "macroCreateWidget",
-    "macroDestroyWidget",
-    "\0"
-  };
-
-  MacroLibraryDLL::MacroLibraryDLL() : MacroLibrary()
-  {
-  }
-
-  MacroLibraryDLL::MacroLibraryDLL(const MacroLibraryDLL& other) : MacroLibrary(other)
+  QAtomicInt MacroLibraryDLL::initCounter;
+
+  MacroLibraryDLL::MacroLibraryDLL() : MacroLibrary(), functions(), libHandler(), macroHandles(), macroInfos(), macroPrototypes(), viewerPrototypes(),
+    initOrder(0), loadMutex()
+  {
+  }
+
+  MacroLibraryDLL::MacroLibraryDLL(const MacroLibraryDLL& other) : MacroLibrary(other), functions(), libHandler(), macroHandles(), macroInfos(), macroPrototypes(), viewerPrototypes(),
+    initOrder(0), loadMutex()
   {
   }
 
   MacroLibraryDLL::~MacroLibraryDLL()
   {
+    qDeleteAll(macroPrototypes);
+    qDeleteAll(viewerPrototypes);
     if (libHandler.isLoaded())
     {
       // Free memory allocated within library
-      FunctionMap::const_iterator it = functions.find(libTerminate);
-      if (it != functions.end())
+      if (functions.libTerminate != 0)
       {
-        PFN_LIBTERM(it.value())();
+        functions.libTerminate();
       }
       libHandler.unload();
     }
   }
 
+  template<class Function> bool MacroLibraryDLL::resolveFunction(Function& func, const char* name, bool required)
+  {
+    func = reinterpret_cast<Function>(libHandler.resolve(name));
+    if (func == 0 && required)
+    {
+      syslog::error(QString(QObject::tr("Missing symbol '%1' in library '%2'. Library not loaded.")).arg(QString(name)).arg(libPath),QObject::tr("Libraries"));
+      return false;
+    }
+    return true;
+  }
+
   bool MacroLibraryDLL::load(const QString& path, MacroManager& manager)
   {
-    MacroHandle* macroList = NULL;
+    if (!open(path) || !initialize()) return false;
+    createPrototypes();
+    return registerPrototypes(manager);
+  }
+
+  bool MacroLibraryDLL::open(const QString& path)
+  {
+    libPath = QDir::toNativeSeparators(path);
     libHandler.setFileName(path);
     if (!libHandler.load())
     {
-      syslog::error(QString(QObject::tr("Operating system cannot load '%1'. Maybe dependencies are missing?")).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
+      syslog::error(QString(QObject::tr("Operating system cannot load '%1'. Maybe dependencies are missing?")).arg(libPath),QObject::tr("Libraries"));
       return false;
     }
     // load symbols from library
-    int index = 0;
-    while(InterfaceFunctionNames[index].length() > 0) {
-      void* funcPtr = (void*)libHandler.resolve(InterfaceFunctionNames[index].toLatin1().constData());
-      if (funcPtr == NULL) {
-        // symbol not found -> invalid library
-        functions.clear();
-        libHandler.unload();
-        syslog::error(QString(QObject::tr("Missing symbol '%1' in library '%2'. Library not loaded.")).arg(InterfaceFunctionNames[index]).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
-        return false;
-      }
-      else {
-        // insert function pointer
-        functions.insert((LibFunctions)index,funcPtr);
-      }
-      ++index;
+    bool resolved =
+      resolveFunction(functions.libGetBuildDate,"libGetBuildDate") &&
+      resolveFunction(functions.libGetCompiler,"libGetCompiler") &&
+      resolveFunction(functions.libGetCompilerId,"libGetCompilerId") &&
+      resolveFunction(functions.libGetQtVersion,"libGetQtVersion") &&
+      resolveFunction(functions.libIsDebugVersion,"libIsDebugVersion") &&
+      resolveFunction(functions.libGetName,"libGetName") &&
+      resolveFunction(functions.libGetVersion,"libGetVersion") &&
+      resolveFunction(functions.libGetAPIVersion,"libGetAPIVersion") &&
+      resolveFunction(functions.libGetCreator,"libGetCreator") &&
+      resolveFunction(functions.libGetDescription,"libGetDescription") &&
+      resolveFunction(functions.libInitialize,"libInitialize") &&
+      resolveFunction(functions.libTerminate,"libTerminate") &&
+      resolveFunction(functions.macroClone,"macroClone") &&
+      resolveFunction(functions.macroDelete,"macroDelete") &&
+      resolveFunction(functions.macroGetType,"macroGetType") &&
+      resolveFunction(functions.macroGetName,"macroGetName") &&
+      resolveFunction(functions.macroGetCreator,"macroGetCreator") &&
+      resolveFunction(functions.macroGetGroup,"macroGetGroup") &&
+      resolveFunction(functions.macroGetDescription,"macroGetDescription") &&
+      resolveFunction(functions.macroGetErrorMsg,"macroGetErrorMsg") &&
+      resolveFunction(functions.macroGetPropertyWidgetComponent,"macroGetPropertyWidgetComponent") &&
+      resolveFunction(functions.macroGetInputs,"macroGetInputs") &&
+      resolveFunction(functions.macroGetOutputs,"macroGetOutputs") &&
+      resolveFunction(functions.macroGetParameters,"macroGetParameters") &&
+      resolveFunction(functions.macroStart,"macroStart") &&
+      resolveFunction(functions.macroApply,"macroApply") &&
+      resolveFunction(functions.macroStop,"macroStop") &&
+      resolveFunction(functions.macroSetParameterValue,"macroSetParameterValue") &&
+      resolveFunction(functions.macroGetParameterValue,"macroGetParameterValue") &&
+      resolveFunction(functions.macroSetImpresarioDataPtr,"macroSetImpresarioDataPtr") &&
+      resolveFunction(functions.macroGetImpresarioDataPtr,"macroGetImpresarioDataPtr") &&
+      resolveFunction(functions.macroCreateWidget,"macroCreateWidget") &&
+      resolveFunction(functions.macroDestroyWidget,"macroDestroyWidget");
+    if (!resolved)
+    {
+      // symbol not found -> invalid library
+      functions = FunctionTable();
+      libHandler.unload();
+      return false;
     }
+    // load optional symbols from library
+    resolveFunction(functions.macroGetOutputSlotCount,"macroGetOutputSlotCount",false);
+    resolveFunction(functions.macroGetOutputSlot,"macroGetOutputSlot",false);
+    resolveFunction(functions.macroSelectOutputSlots,"macroSelectOutputSlots",false);
+    resolveFunction(functions.macroGetParameterType,"macroGetParameterType",false);
+    resolveFunction(functions.macroSetParameterData,"macroSetParameterData",false);
+    resolveFunction(functions.macroGetParameterData,"macroGetParameterData",false);
+    return true;
+  }
+
+  bool MacroLibraryDLL::initialize()
+  {
     // initialize the library
+    MacroHandle* macroList = NULL;
     unsigned int cntElements;
-    bool init = PFN_LIBINIT(functions[libInitialize])(&macroList,&cntElements,&std::ConsoleInterface::receivedStdOut,&std::ConsoleInterface::receivedStdErr,&cbMacroParameterChanged);
+    bool init = functions.libInitialize(&macroList,&cntElements,&std::ConsoleInterface::receivedStdOut,&std::ConsoleInterface::receivedStdErr,&cbMacroParameterChanged);
     if (!init || cntElements == 0) {
-      functions.clear();
+      functions = FunctionTable();
       libHandler.unload();
       if (!init) {
-        syslog::error(QString(QObject::tr("'%1' could not be initialized. Library not loaded.")).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
+        syslog::error(QString(QObject::tr("'%1' could not be initialized. Library not loaded.")).arg(libPath),QObject::tr("Libraries"));
       }
       else {
-        syslog::warning(QString(QObject::tr("'%1' does not contain any macros. Library not loaded.")).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
+        syslog::warning(QString(QObject::tr("'%1' does not contain any macros. Library not loaded.")).arg(libPath),QObject::tr("Libraries"));
       }
       return false;
     }
     // initialize remaining attributes
-    libName = QString::fromWCharArray(PFN_LIBSTRING(functions[libGetName])());
-    libPath = QDir::toNativeSeparators(path);
-    libCreator = QString::fromWCharArray(PFN_LIBSTRING(functions[libGetCreator])());
-    libDescription = QString::fromWCharArray(PFN_LIBSTRING(functions[libGetDescription])());
-    libBuildDate = QString::fromWCharArray(PFN_LIBSTRING(functions[libGetBuildDate])());
-    libCompiler = QString::fromWCharArray(PFN_LIBSTRING(functions[libGetCompiler])());
-    libCompilerVersion = PFN_LIBUINT(functions[libGetCompilerId])();
-    libVersion = PFN_LIBUINT(functions[libGetVersion])();
-    libQtVersion = PFN_LIBUINT(functions[libGetQtVersion])();
-    libAPIVersion = PFN_LIBUINT(functions[libGetAPIVersion])();
+    libName = QString::fromWCharArray(functions.libGetName());
+    libCreator = QString::fromWCharArray(functions.libGetCreator());
+    libDescription = QString::fromWCharArray(functions.libGetDescription());
+    libBuildDate = QString::fromWCharArray(functions.libGetBuildDate());
+    libCompiler = QString::fromWCharArray(functions.libGetCompiler());
+    libCompilerVersion = functions.libGetCompilerId();
+    libVersion = functions.libGetVersion();
+    libQtVersion = functions.libGetQtVersion();
+    libAPIVersion = functions.libGetAPIVersion();
+    libIsDebug = functions.libIsDebugVersion();
+    updateVersionStrings();
+    macroHandles.reserve(cntElements);
+    for(unsigned int index = 0; index < cntElements; ++index)
+    {
+      macroHandles.append(macroList[index]);
+    }
+    initOrder = initCounter.fetchAndAddOrdered(1) + 1;
+    return true;
+  }
+
+  void MacroLibraryDLL::updateVersionStrings()
+  {
     if (libQtVersion > 0)
     {
       unsigned int patch = libQtVersion & 0xFF;
@@ -182,97 +221,316 @@ namespace app
       unsigned int major = (libVersion & 0xFF0000) >> 16;
       libVersionString = QString("%1.%2.%3").arg(major).arg(minor).arg(patch);
     }
-    libIsDebug = PFN_LIBBOOL(functions[libIsDebugVersion])();
     libBuildType = app::BuildInfo::instance().buildString(libCompilerVersion,libIsDebug);
-    // try to add all macros of the library to the macro map
-    for(unsigned int index = 0; index < cntElements; ++index)
+  }
+
+  MacroLibraryDLL::MacroInfo MacroLibraryDLL::describeMacro(const MacroHandle handle, unsigned int index) const
+  {
+    MacroInfo info;
+    info.index = index;
+    info.type = getMacroType(handle);
+    info.name = getMacroName(handle);
+    info.creator = getMacroCreator(handle);
+    info.group = getMacroGroup(handle);
+    info.description = getMacroDescription(handle);
+    info.propertyWidgetComponent = getMacroPropertyWidgetComponent(handle);
+    // describe macro inputs
+    unsigned int count = 0;
+    DataDescriptor* dataDescr = getMacroInputs(handle,count);
+    while(dataDescr)
     {
-      unsigned int macroType = getMacroType(macroList[index]);
-      switch(macroType)
+      PinInfo pin;
+      pin.name = QString::fromWCharArray(dataDescr->name);
+      pin.description = QString::fromWCharArray(dataDescr->description);
+      pin.type = QString::fromLatin1(dataDescr->type);
+      pin.typeId = getTypeId(dataDescr);
+      pin.valuePtr = dataDescr->valuePtr;
+      info.inputs.append(pin);
+      dataDescr = dataDescr->next;
+    }
+    // describe macro outputs
+    count = 0;
+    dataDescr = getMacroOutputs(handle,count);
+    unsigned int outputIndex = 0;
+    while(dataDescr)
+    {
+      PinInfo pin;
+      pin.name = QString::fromWCharArray(dataDescr->name);
+      pin.description = QString::fromWCharArray(dataDescr->description);
+      pin.type = QString::fromLatin1(dataDescr->type);
+      pin.typeId = getTypeId(dataDescr);
+      pin.valuePtr = dataDescr->valuePtr;
+      // outputs of libraries with interface version 1.1.0 or above may provide a ring of slots
+      unsigned int slotCount = getMacroOutputSlotCount(handle,outputIndex);
+      for(unsigned int slot = 0; slotCount > 1 && slot < slotCount; ++slot)
+      {
+        pin.outputSlots.append(getMacroOutputSlot(handle,outputIndex,slot));
+      }
+      if (pin.outputSlots.contains(0))
+      {
+        pin.outputSlots.clear();
+      }
+      info.outputs.append(pin);
+      dataDescr = dataDescr->next;
+      ++outputIndex;
+    }
+    // describe macro parameters
+    dataDescr = getMacroParameters(handle,count);
+    count = 0;
+    while(dataDescr)
+    {
+      ParameterInfo param;
+      param.name = QString::fromWCharArray(dataDescr->name);
+      param.description = QString::fromWCharArray(dataDescr->description);
+      param.type = QString::fromLatin1(dataDescr->type);
+      if (dataDescr->valuePtr != 0)
+      {
+        param.config = QString::fromWCharArray(reinterpret_cast<const wchar_t*>(dataDescr->valuePtr));
+      }
+      param.valueType = getMacroParameterType(handle,count);
+      param.value = getMacroParameter(handle,count++);
+      info.parameters.append(param);
+      dataDescr = dataDescr->next;
+    }
+    return info;
+  }
+
+  quint64 MacroLibraryDLL::getTypeId(const DataDescriptor* dataDescr) const
+  {
+    // descriptors of libraries with interface version 1.1.0 or above carry the id of their type
+    if (libAPIVersion >= 0x010100)
+    {
+      return dataDescr->typeId;
+    }
+    return typeIdFromName(QByteArray(dataDescr->type));
+  }
+
+  quint64 MacroLibraryDLL::typeIdFromName(const QByteArray& typeName)
+  {
+    // 64-bit FNV-1a hash as computed by macro libraries with interface version 1.1.0
+    quint64 id = Q_UINT64_C(14695981039346656037);
+    for(int index = 0; index < typeName.size(); ++index)
+    {
+      id ^= static_cast<unsigned char>(typeName[index]);
+      id *= Q_UINT64_C(1099511628211);
+    }
+    return id;
+  }
+
+  void MacroLibraryDLL::createPrototypes()
+  {
+    // libraries restored from their manifest already provide the description of their macros
+    if (macroInfos.isEmpty())
+    {
+      for(int index = 0; index < macroHandles.count(); ++index)
+      {
+        macroInfos.append(describeMacro(macroHandles[index],index));
+      }
+    }
+    foreach(const MacroInfo& info, macroInfos)
+    {
+      MacroHandle handle = macroHandles.value(info.index,0);
+      switch(info.type)
       {
         case 0: // load a normal macro not depending on Qt
         {
-          graph::VertexData::Ptr macro = graph::VertexData::Ptr(new MacroDLL(*this,macroList[index]));
-          if (!macro.isNull())
-          {
-            if (!manager.registerVertexDataType(macro))
-            {
-              syslog::warning(QString(QObject::tr("Macro '%1' from library '%2' is already contained in database.")).arg(static_cast<app::Macro*>(macro.data())->getName()).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
-              macro = graph::VertexData::Ptr();
-            }
-            else
-            {
-              libCntMacros++;
-            }
-          }
-          else
-          {
-            syslog::error(QString(QObject::tr("Failed to allocate memory for a macro in '%1'.")).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
-          }
+          macroPrototypes.append(new MacroDLL(*this,handle,info));
           break;
         }
         case 1: // load an extended macro depending on Qt -> check for runtime compatibility!
         {
-          graph::VertexData::Ptr macro = graph::VertexData::Ptr(new MacroDLL(*this,macroList[index]));
-          if (!macro.isNull())
+          MacroDLL* macro = new MacroDLL(*this,handle,info);
+          if (isMacroCompatible(*macro))
           {
-            if (isMacroCompatible(*static_cast<app::MacroDLL*>(macro.data())))
-            {
-              if (!manager.registerVertexDataType(macro))
-              {
-                syslog::warning(QString(QObject::tr("Macro '%1' from library '%2' is already contained in database.")).arg(static_cast<app::Macro*>(macro.data())->getName()).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
-                macro = graph::VertexData::Ptr();
-              }
-              else
-              {
-                libCntMacros++;
-              }
-            }
+            macroPrototypes.append(macro);
           }
           else
           {
-            syslog::error(QString(QObject::tr("Failed to allocate memory for a macro in '%1'.")).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
+            delete macro;
           }
           break;
         }
         case 2: // load a viewer depending on Qt
         {
-          app::MacroViewer::Ptr viewer = app::MacroViewer::Ptr(new MacroViewer(*this,macroList[index]));
-          if (!viewer.isNull())
+          MacroViewer* viewer = new MacroViewer(*this,handle,info);
+          if (isMacroCompatible(*viewer))
           {
-            if (isMacroCompatible(*viewer.data()))
-            {
-              if (!manager.registerMacroViewer(viewer))
-              {
-                syslog::warning(QString(QObject::tr("Viewer '%1' from library '%2' could not be registered.")).arg(static_cast<app::Macro*>(viewer.data())->getName()).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
-                viewer = app::MacroViewer::Ptr();
-              }
-              else
-              {
-                libCntViewers++;
-              }
-            }
+            viewerPrototypes.append(viewer);
           }
           else
           {
-            syslog::error(QString(QObject::tr("Failed to allocate memory for a viewer in '%1'.")).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
+            delete viewer;
           }
           break;
         }
         default:
-          syslog::warning(QString(QObject::tr("'%1' contains macros of invalid type. Skipping.")).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
+          syslog::warning(QString(QObject::tr("'%1' contains macros of invalid type. Skipping.")).arg(libPath),QObject::tr("Libraries"));
           break;
       }
     }
+  }
+
+  bool MacroLibraryDLL::registerPrototypes(MacroManager& manager)
+  {
+    foreach(MacroDLL* prototype, macroPrototypes)
+    {
+      graph::VertexData::Ptr macro = graph::VertexData::Ptr(prototype);
+      if (!manager.registerVertexDataType(macro))
+      {
+        syslog::warning(QString(QObject::tr("Macro '%1' from library '%2' is already contained in database.")).arg(prototype->getName()).arg(libPath),QObject::tr("Libraries"));
+      }
+      else
+      {
+        libCntMacros++;
+      }
+    }
+    macroPrototypes.clear();
+    foreach(MacroViewer* prototype, viewerPrototypes)
+    {
+      app::MacroViewer::Ptr viewer = app::MacroViewer::Ptr(prototype);
+      if (!manager.registerMacroViewer(viewer))
+      {
+        syslog::warning(QString(QObject::tr("Viewer '%1' from library '%2' could not be registered.")).arg(prototype->getName()).arg(libPath),QObject::tr("Libraries"));
+      }
+      else
+      {
+        libCntViewers++;
+      }
+    }
+    viewerPrototypes.clear();
     if (libCntMacros + libCntViewers == 0)
     {
-      syslog::warning(QString(QObject::tr("'%1' skipped. Neither macros nor viewers loaded.")).arg(QDir::toNativeSeparators(path)),QObject::tr("Libraries"));
+      syslog::warning(QString(QObject::tr("'%1' skipped. Neither macros nor viewers loaded.")).arg(libPath),QObject::tr("Libraries"));
       return false;
     }
-    syslog::info(QString(QObject::tr("'%1' loaded. Registered macros: %2. Registered viewers: %3.")).arg(QDir::toNativeSeparators(path)).arg(libCntMacros).arg(libCntViewers),QObject::tr("Libraries"));
+    if (libHandler.isLoaded())
+    {
+      syslog::info(QString(QObject::tr("'%1' loaded. Registered macros: %2. Registered viewers: %3.")).arg(libPath).arg(libCntMacros).arg(libCntViewers),QObject::tr("Libraries"));
+    }
+    else
+    {
+      syslog::info(QString(QObject::tr("'%1' restored from cache. Registered macros: %2. Registered viewers: %3.")).arg(libPath).arg(libCntMacros).arg(libCntViewers),QObject::tr("Libraries"));
+    }
     return true;
   }
 
+  QByteArray MacroLibraryDLL::manifest() const
+  {
+    QByteArray data;
+    QDataStream stream(&data,QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << libName << libCreator << libDescription << libBuildDate << libCompiler;
+    stream << quint32(libVersion) << quint32(libCompilerVersion) << quint32(libQtVersion) << quint32(libAPIVersion) << libIsDebug;
+    stream << quint32(macroInfos.count());
+    foreach(const MacroInfo& info, macroInfos)
+    {
+      stream << quint32(info.index) << quint32(info.type) << info.name << info.creator << info.group << info.description << info.propertyWidgetComponent;
+      stream << quint32(info.inputs.count());
+      foreach(const PinInfo& pin, info.inputs)
+      {
+        stream << pin.name << pin.description << pin.type;
+      }
+      stream << quint32(info.outputs.count());
+      foreach(const PinInfo& pin, info.outputs)
+      {
+        stream << pin.name << pin.description << pin.type;
+      }
+      stream << quint32(info.parameters.count());
+      foreach(const ParameterInfo& param, info.parameters)
+      {
+        stream << param.name << param.description << param.type << param.config << param.value << quint32(param.valueType);
+      }
+    }
+    return data;
+  }
+
+  bool MacroLibraryDLL::restore(const QString& path, const QByteArray& manifest)
+  {
+    libPath = QDir::toNativeSeparators(path);
+    QDataStream stream(manifest);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 version, compilerVersion, qtVersion, apiVersion, count;
+    stream >> libName >> libCreator >> libDescription >> libBuildDate >> libCompiler;
+    stream >> version >> compilerVersion >> qtVersion >> apiVersion >> libIsDebug;
+    stream >> count;
+    libVersion = version;
+    libCompilerVersion = compilerVersion;
+    libQtVersion = qtVersion;
+    libAPIVersion = apiVersion;
+    updateVersionStrings();
+    macroInfos.clear();
+    for(quint32 index = 0; index < count && stream.status() == QDataStream::Ok; ++index)
+    {
+      MacroInfo info;
+      quint32 macroIndex, macroType, pinCount;
+      stream >> macroIndex >> macroType >> info.name >> info.creator >> info.group >> info.description >> info.propertyWidgetComponent;
+      info.index = macroIndex;
+      info.type = macroType;
+      stream >> pinCount;
+      for(quint32 pinIndex = 0; pinIndex < pinCount && stream.status() == QDataStream::Ok; ++pinIndex)
+      {
+        PinInfo pin;
+        stream >> pin.name >> pin.description >> pin.type;
+        pin.typeId = typeIdFromName(pin.type.toLatin1());
+        pin.valuePtr = 0;
+        info.inputs.append(pin);
+      }
+      stream >> pinCount;
+      for(quint32 pinIndex = 0; pinIndex < pinCount && stream.status() == QDataStream::Ok; ++pinIndex)
+      {
+        PinInfo pin;
+        stream >> pin.name >> pin.description >> pin.type;
+        pin.typeId = typeIdFromName(pin.type.toLatin1());
+        pin.valuePtr = 0;
+        info.outputs.append(pin);
+      }
+      stream >> pinCount;
+      for(quint32 paramIndex = 0; paramIndex < pinCount && stream.status() == QDataStream::Ok; ++paramIndex)
+      {
+        ParameterInfo param;
+        quint32 valueType;
+        stream >> param.name >> param.description >> param.type >> param.config >> param.value >> valueType;
+        param.valueType = valueType;
+        info.parameters.append(param);
+      }
+      macroInfos.append(info);
+    }
+    if (stream.status() != QDataStream::Ok || macroInfos.isEmpty())
+    {
+      macroInfos.clear();
+      return false;
+    }
+    return true;
+  }
+
+  MacroLibraryDLL::MacroHandle MacroLibraryDLL::loadMacroHandle(unsigned int index) const
+  {
+    QMutexLocker lock(&loadMutex);
+    if (!libHandler.isLoaded())
+    {
+      // the library is restored from its manifest, so it is loaded on first use
+      MacroLibraryDLL& lib = const_cast<MacroLibraryDLL&>(*this);
+      if (!lib.open(QDir::fromNativeSeparators(libPath)) || !lib.initialize())
+      {
+        return 0;
+      }
+      bool matches = (macroHandles.count() == macroInfos.count());
+      for(int infoIndex = 0; matches && infoIndex < macroInfos.count(); ++infoIndex)
+      {
+        const MacroInfo& info = macroInfos[infoIndex];
+        matches = (info.index < (unsigned int)macroHandles.count() && getMacroName(macroHandles[info.index]) == info.name);
+      }
+      if (!matches)
+      {
+        lib.macroHandles.clear();
+        syslog::error(QString(QObject::tr("'%1' changed since its macros were cached. Restart Impresario to reload the library.")).arg(libPath),QObject::tr("Libraries"));
+        return 0;
+      }
+      syslog::info(QString(QObject::tr("'%1' loaded on demand.")).arg(libPath),QObject::tr("Libraries"));
+    }
+    return macroHandles.value(index,0);
+  }
+
   bool MacroLibraryDLL::isMacroCompatible(const MacroDLL& macro)
   {
     unsigned int impresarioCompiler = app::BuildInfo::instance().compilerId();
@@ -316,106 +574,209 @@ namespace app
 
   unsigned int MacroLibraryDLL::getMacroType(const MacroHandle handle) const
   {
-    return (PFN_MACUINT(functions[macroGetType])(handle));
+    return (functions.macroGetType(handle));
   }
 
   QString MacroLibraryDLL::getMacroName(const MacroHandle handle) const
   {
-    return QString::fromWCharArray(PFN_MACSTRING(functions[macroGetName])(handle));
+    return QString::fromWCharArray(functions.macroGetName(handle));
   }
 
   QString MacroLibraryDLL::getMacroCreator(const MacroHandle handle) const
   {
-    return QString::fromWCharArray(PFN_MACSTRING(functions[macroGetCreator])(handle));
+    return QString::fromWCharArray(functions.macroGetCreator(handle));
   }
 
   QString MacroLibraryDLL::getMacroGroup(const MacroHandle handle) const
   {
-    return QString::fromWCharArray(PFN_MACSTRING(functions[macroGetGroup])(handle));
+    return QString::fromWCharArray(functions.macroGetGroup(handle));
   }
 
   QString MacroLibraryDLL::getMacroDescription(const MacroHandle handle) const
   {
-    return QString::fromWCharArray(PFN_MACSTRING(functions[macroGetDescription])(handle));
+    return QString::fromWCharArray(functions.macroGetDescription(handle));
   }
 
   QString MacroLibraryDLL::getMacroErrorMsg(const MacroHandle handle) const
   {
-    return QString::fromWCharArray(PFN_MACSTRING(functions[macroGetErrorMsg])(handle));
+    return QString::fromWCharArray(functions.macroGetErrorMsg(handle));
   }
 
   QString MacroLibraryDLL::getMacroPropertyWidgetComponent(const MacroHandle handle) const
   {
-    return QString::fromWCharArray(PFN_MACSTRING(functions[macroGetPropertyWidgetComponent])(handle));
+    return QString::fromWCharArray(functions.macroGetPropertyWidgetComponent(handle));
   }
 
   void MacroLibraryDLL::setMacroImpresarioDataPtr(const MacroHandle handle, void* dataPtr) const
   {
-    return PFN_MACSETPTR(functions[macroSetImpresarioDataPtr])(handle,dataPtr);
+    return functions.macroSetImpresarioDataPtr(handle,dataPtr);
   }
 
   void* MacroLibraryDLL::getMacroImpresarioDataPtr(const MacroHandle handle) const
   {
-    return PFN_MACVOIDPTR(functions[macroGetImpresarioDataPtr])(handle);
+    return functions.macroGetImpresarioDataPtr(handle);
   }
 
   MacroLibraryDLL::DataDescriptor* MacroLibraryDLL::getMacroInputs(const MacroHandle handle, unsigned int& count) const
   {
-    return PFN_MACDATA(functions[macroGetInputs])(handle,&count);
+    return functions.macroGetInputs(handle,&count);
   }
 
   MacroLibraryDLL::DataDescriptor* MacroLibraryDLL::getMacroOutputs(const MacroHandle handle, unsigned int& count) const
   {
-    return PFN_MACDATA(functions[macroGetOutputs])(handle,&count);
+    return functions.macroGetOutputs(handle,&count);
   }
 
   MacroLibraryDLL::DataDescriptor* MacroLibraryDLL::getMacroParameters(const MacroHandle handle, unsigned int& count) const
   {
-    return PFN_MACDATA(functions[macroGetParameters])(handle,&count);
+    return functions.macroGetParameters(handle,&count);
   }
 
   MacroLibraryDLL::MacroHandle MacroLibraryDLL::cloneMacro(const MacroHandle handle) const
   {
-    return PFN_MACCLONE(functions[macroClone])(handle);
+    return functions.macroClone(handle);
   }
 
   bool MacroLibraryDLL::deleteMacro(const MacroHandle handle) const
   {
-    return PFN_MACBOOL(functions[macroDelete])(handle);
+    return functions.macroDelete(handle);
   }
 
   int MacroLibraryDLL::startMacro(const MacroHandle handle) const
   {
-    return PFN_MACINT(functions[macroStart])(handle);
+    return functions.macroStart(handle);
   }
 
   int MacroLibraryDLL::applyMacro(const MacroHandle handle) const
   {
-    return PFN_MACINT(functions[macroApply])(handle);
+    return functions.macroApply(handle);
   }
 
   int MacroLibraryDLL::stopMacro(const MacroHandle handle) const
   {
-    return PFN_MACINT(functions[macroStop])(handle);
+    return functions.macroStop(handle);
   }
 
   void MacroLibraryDLL::setMacroParameter(const MacroHandle handle, unsigned int paramIndex, const QString& value) const
   {
-    return PFN_MACSETPARAM(functions[macroSetParameterValue])(handle,paramIndex,value.toStdWString().c_str());
+    return functions.macroSetParameterValue(handle,paramIndex,value.toStdWString().c_str());
   }
 
   QString MacroLibraryDLL::getMacroParameter(const MacroHandle handle, unsigned int paramIndex) const
   {
-    return QString::fromWCharArray(PFN_MACGETPARAM(functions[macroGetParameterValue])(handle,paramIndex));
+    return QString::fromWCharArray(functions.macroGetParameterValue(handle,paramIndex));
+  }
+
+  unsigned int MacroLibraryDLL::getMacroParameterType(const MacroHandle handle, unsigned int paramIndex) const
+  {
+    if (functions.macroGetParameterType == 0)
+    {
+      return ParamText;
+    }
+    return functions.macroGetParameterType(handle,paramIndex);
+  }
+
+  bool MacroLibraryDLL::setMacroParameterData(const MacroHandle handle, unsigned int paramIndex, unsigned int paramType, const QVariant& value) const
+  {
+    if (functions.macroSetParameterData == 0)
+    {
+      return false;
+    }
+    bool ok = false;
+    switch(paramType)
+    {
+      case ParamInt:
+      case ParamEnum:
+      {
+        qint64 data = value.toLongLong(&ok);
+        return ok && functions.macroSetParameterData(handle,paramIndex,&data,sizeof(data));
+      }
+      case ParamBool:
+      {
+        qint64 data = (value.toBool()) ? 1 : 0;
+        return functions.macroSetParameterData(handle,paramIndex,&data,sizeof(data));
+      }
+      case ParamDouble:
+      {
+        double data = value.toDouble(&ok);
+        return ok && functions.macroSetParameterData(handle,paramIndex,&data,sizeof(data));
+      }
+      case ParamBlob:
+      {
+        // binary data is represented by a string of hexadecimal digits
+        QByteArray data = QByteArray::fromHex(value.toString().toLatin1());
+        return functions.macroSetParameterData(handle,paramIndex,data.constData(),data.size());
+      }
+      default:
+        return false;
+    }
+  }
+
+  bool MacroLibraryDLL::getMacroParameterData(const MacroHandle handle, unsigned int paramIndex, unsigned int paramType, QString& value) const
+  {
+    if (functions.macroGetParameterData == 0 || paramType == ParamText)
+    {
+      return false;
+    }
+    unsigned int size = 0;
+    const void* data = functions.macroGetParameterData(handle,paramIndex,&size);
+    if (data == 0 && size > 0)
+    {
+      return false;
+    }
+    switch(paramType)
+    {
+      case ParamInt:
+      case ParamEnum:
+      case ParamBool:
+        if (size != sizeof(qint64)) return false;
+        value = QString::number(*static_cast<const qint64*>(data));
+        return true;
+      case ParamDouble:
+        if (size != sizeof(double)) return false;
+        value = QString::number(*static_cast<const double*>(data),'g',QLocale::FloatingPointShortest);
+        return true;
+      case ParamBlob:
+        value = QString::fromLatin1(QByteArray::fromRawData(static_cast<const char*>(data),size).toHex());
+        return true;
+      default:
+        return false;
+    }
   }
 
   void* MacroLibraryDLL::createMacroWidget(const MacroHandle handle) const
   {
-    return PFN_MACVOIDPTR(functions[macroCreateWidget])(handle);
+    return functions.macroCreateWidget(handle);
   }
 
   void MacroLibraryDLL::destroyMacroWidget(const MacroHandle handle) const
   {
-    return PFN_MACVOID(functions[macroDestroyWidget])(handle);
+    return functions.macroDestroyWidget(handle);
+  }
+
+  unsigned int MacroLibraryDLL::getMacroOutputSlotCount(const MacroHandle handle, unsigned int outputIndex) const
+  {
+    if (functions.macroGetOutputSlotCount == 0)
+    {
+      return 1;
+    }
+    return functions.macroGetOutputSlotCount(handle,outputIndex);
+  }
+
+  void* MacroLibraryDLL::getMacroOutputSlot(const MacroHandle handle, unsigned int outputIndex, unsigned int slot) const
+  {
+    if (functions.macroGetOutputSlot == 0)
+    {
+      return 0;
+    }
+    return functions.macroGetOutputSlot(handle,outputIndex,slot);
+  }
+
+  void MacroLibraryDLL::selectMacroOutputSlots(const MacroHandle handle, unsigned int frame) const
+  {
+    if (functions.macroSelectOutputSlots != 0)
+    {
+      functions.macroSelectOutputSlots(handle,frame);
+    }
   }
 }
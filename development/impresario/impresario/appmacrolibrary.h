@@ -22,13 +22,19 @@
 #define APPMACROLIBRARY_H
 
 #include <QString>
-#include <QMap>
+#include <QList>
+#include <QVector>
 #include <QLibrary>
+#include <QMutex>
+#include <QByteArray>
+#include <QAtomicInt>
+#include <QVariant>
 
 namespace app
 {
   // forward declaration to prevent circular reference of header files
   class MacroDLL;
+  class MacroViewer;
   class MacroManager;
 
   class MacroLibrary
@@ -156,6 +162,23 @@ namespace app
     virtual bool load(const QString& path, MacroManager& manager);
     bool isMacroCompatible(const MacroDLL& macro);
 
+    // Stages of load(). open() and createPrototypes() may run for several libraries in parallel.
+    // initialize() and registerPrototypes() have to be called for one library after another.
+    bool open(const QString& path);
+    bool initialize();
+    void createPrototypes();
+    bool registerPrototypes(MacroManager& manager);
+
+    // The manifest describes all macros of the library. A library restored from its manifest
+    // is loaded by the operating system not before one of its macros is instantiated.
+    QByteArray manifest() const;
+    bool restore(const QString& path, const QByteArray& manifest);
+
+    int initializationOrder() const
+    {
+      return initOrder;
+    }
+
   private:
     /**
      * Type definition for a macro handle as it is used by the
@@ -174,6 +197,70 @@ namespace app
       const char*     type;
       void*           valuePtr;
       DataDescriptor* next;
+      quint64         typeId; // since interface version 1.1.0
+    };
+
+    /**
+     * Description of a macro as it is stored in the manifest. Value and slot pointers are
+     * only available for macros described by a loaded library.
+     */
+    struct PinInfo
+    {
+      QString        name;
+      QString        description;
+      QString        type;
+      quint64        typeId;
+      void*          valuePtr;
+      QVector<void*> outputSlots;
+    };
+
+    struct ParameterInfo
+    {
+      QString      name;
+      QString      description;
+      QString      type;
+      QString      config;
+      QString      value;
+      unsigned int valueType;
+    };
+
+    struct MacroInfo
+    {
+      unsigned int         index;
+      unsigned int         type;
+      QString              name;
+      QString              creator;
+      QString              group;
+      QString              description;
+      QString              propertyWidgetComponent;
+      QList<PinInfo>       inputs;
+      QList<PinInfo>       outputs;
+      QList<ParameterInfo> parameters;
+    };
+
+    MacroInfo describeMacro(const MacroHandle handle, unsigned int index = 0) const;
+    quint64 getTypeId(const DataDescriptor* dataDescr) const;
+    static quint64 typeIdFromName(const QByteArray& typeName);
+    void updateVersionStrings();
+
+    /**
+     * Loads a library restored from its manifest and returns the handle of the macro
+     * with the given index. Returns 0 if the library does not match its manifest anymore.
+     */
+    MacroHandle loadMacroHandle(unsigned int index) const;
+
+    /**
+     * Raw representation of parameter values as defined by macro library interface 1.1.0.
+     * Int, bool, and enum values are exchanged as 64-bit integer, real values as double.
+     */
+    enum ParameterType
+    {
+      ParamText = 0,
+      ParamInt,
+      ParamDouble,
+      ParamBool,
+      ParamEnum,
+      ParamBlob
     };
 
     /**
@@ -200,8 +287,14 @@ namespace app
     int stopMacro(const MacroHandle handle) const;
     void setMacroParameter(const MacroHandle handle, unsigned int paramIndex, const QString& value) const;
     QString getMacroParameter(const MacroHandle handle, unsigned int paramIndex) const;
+    unsigned int getMacroParameterType(const MacroHandle handle, unsigned int paramIndex) const;
+    bool setMacroParameterData(const MacroHandle handle, unsigned int paramIndex, unsigned int paramType, const QVariant& value) const;
+    bool getMacroParameterData(const MacroHandle handle, unsigned int paramIndex, unsigned int paramType, QString& value) const;
     void* createMacroWidget(const MacroHandle handle) const;
     void destroyMacroWidget(const MacroHandle handle) const;
+    unsigned int getMacroOutputSlotCount(const MacroHandle handle, unsigned int outputIndex) const;
+    void* getMacroOutputSlot(const MacroHandle handle, unsigned int outputIndex, unsigned int slot) const;
+    void selectMacroOutputSlots(const MacroHandle handle, unsigned int frame) const;
 
     // Function type definitions for Impresario interface
     typedef const wchar_t*  (* PFN_LIBSTRING)  ();
@@ -220,67 +313,93 @@ namespace app
     typedef void*           (* PFN_MACVOIDPTR) (MacroHandle);
     typedef void            (* PFN_MACVOID)    (MacroHandle);
     typedef void            (* PFN_MACSETPTR)  (MacroHandle,void*);
+    typedef unsigned int    (* PFN_MACSLOTCNT) (MacroHandle,unsigned int);
+    typedef void*           (* PFN_MACSLOTPTR) (MacroHandle,unsigned int,unsigned int);
+    typedef void            (* PFN_MACSLOTSEL) (MacroHandle,unsigned int);
+    typedef unsigned int    (* PFN_MACPARTYPE) (MacroHandle,unsigned int);
+    typedef bool            (* PFN_MACSETDATA) (MacroHandle,unsigned int,const void*,unsigned int);
+    typedef const void*     (* PFN_MACGETDATA) (MacroHandle,unsigned int,unsigned int*);
 
     /**
-     * Enumeration of all functions imported from loaded DLL which deals with
-     * library organization. This enumeration is private because these functions
-     * are just accessed by this class.
+     * Pointers to all functions imported from loaded DLL. They are resolved once
+     * when the library is loaded, so calls into the library do not need any lookup.
+     * Optional functions are null if the library does not export them.
      */
-    enum LibFunctions {
-      libGetBuildDate,
-      libGetCompiler,
-      libGetCompilerId,
-      libGetQtVersion,
-      libIsDebugVersion,
-      libGetName,
-      libGetVersion,
-      libGetAPIVersion,
-      libGetCreator,
-      libGetDescription,
-      libInitialize,
-      libTerminate,
-      macroClone,
-      macroDelete,
-      macroGetType,
-      macroGetName,
-      macroGetCreator,
-      macroGetGroup,
-      macroGetDescription,
-      macroGetErrorMsg,
-      macroGetPropertyWidgetComponent,
-      macroGetInputs,
-      macroGetOutputs,
-      macroGetParameters,
-      macroStart,
-      macroApply,
-      macroStop,
-      macroSetParameterValue,
-      macroGetParameterValue,
-      macroSetImpresarioDataPtr,
-      macroGetImpresarioDataPtr,
-      macroCreateWidget,
-      macroDestroyWidget
+    struct FunctionTable
+    {
+      PFN_LIBSTRING   libGetBuildDate;
+      PFN_LIBSTRING   libGetCompiler;
+      PFN_LIBUINT     libGetCompilerId;
+      PFN_LIBUINT     libGetQtVersion;
+      PFN_LIBBOOL     libIsDebugVersion;
+      PFN_LIBSTRING   libGetName;
+      PFN_LIBUINT     libGetVersion;
+      PFN_LIBUINT     libGetAPIVersion;
+      PFN_LIBSTRING   libGetCreator;
+      PFN_LIBSTRING   libGetDescription;
+      PFN_LIBINIT     libInitialize;
+      PFN_LIBTERM     libTerminate;
+      PFN_MACCLONE    macroClone;
+      PFN_MACBOOL     macroDelete;
+      PFN_MACUINT     macroGetType;
+      PFN_MACSTRING   macroGetName;
+      PFN_MACSTRING   macroGetCreator;
+      PFN_MACSTRING   macroGetGroup;
+      PFN_MACSTRING   macroGetDescription;
+      PFN_MACSTRING   macroGetErrorMsg;
+      PFN_MACSTRING   macroGetPropertyWidgetComponent;
+      PFN_MACDATA     macroGetInputs;
+      PFN_MACDATA     macroGetOutputs;
+      PFN_MACDATA     macroGetParameters;
+      PFN_MACINT      macroStart;
+      PFN_MACINT      macroApply;
+      PFN_MACINT      macroStop;
+      PFN_MACSETPARAM macroSetParameterValue;
+      PFN_MACGETPARAM macroGetParameterValue;
+      PFN_MACSETPTR   macroSetImpresarioDataPtr;
+      PFN_MACVOIDPTR  macroGetImpresarioDataPtr;
+      PFN_MACVOIDPTR  macroCreateWidget;
+      PFN_MACVOID     macroDestroyWidget;
+      // optional functions introduced with interface version 1.1.0
+      PFN_MACSLOTCNT  macroGetOutputSlotCount;
+      PFN_MACSLOTPTR  macroGetOutputSlot;
+      PFN_MACSLOTSEL  macroSelectOutputSlots;
+      PFN_MACPARTYPE  macroGetParameterType;
+      PFN_MACSETDATA  macroSetParameterData;
+      PFN_MACGETDATA  macroGetParameterData;
     };
 
     /**
-     * Map type for holding all pointers to functions located in the loaded DLL.
+     * Resolves a single function of the library. Missing required functions are reported.
      */
-    typedef QMap<LibFunctions,void*> FunctionMap;
+    template<class Function> bool resolveFunction(Function& func, const char* name, bool required = true);
 
     /**
-     * Array of function names to be imported from DLL
+     * Table containing all function pointers into macro library.
      */
-    static const QString InterfaceFunctionNames[];
+    FunctionTable functions;
 
     /**
-     * Map containing all function pointers into macro library.
+     * Handle to the dynamic link library.
      */
-    FunctionMap functions;
+    QLibrary libHandler;
 
     /**
-     * Handle to the dynamic link library.
+     * Macros provided by the library after initialization and prototypes created from them
+     * which are not yet registered.
      */
-    QLibrary libHandler;
+    QList<MacroHandle>   macroHandles;
+    QList<MacroInfo>     macroInfos;
+    QList<MacroDLL*>     macroPrototypes;
+    QList<MacroViewer*>  viewerPrototypes;
+
+    /**
+     * Position of the library in the sequence of initialized libraries. Zero if the library
+     * was not initialized yet.
+     */
+    int                  initOrder;
+    static QAtomicInt    initCounter;
+    mutable QMutex       loadMutex;
   };
 
 }
@@ -23,14 +23,22 @@
 #include "appmacro.h"
 #include "sysloglogger.h"
 #include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QSaveFile>
 #include <QRegularExpression>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
 #include <QtConcurrent>
+#include <algorithm>
 
 namespace app
 {
   MacroManager MacroManager::macroManager;
 
-  MacroManager::MacroManager() : graph::ElementManager(), libList()
+  MacroManager::MacroManager() : graph::ElementManager(), libList(), viewers(), viewerIds(), manifestFile()
   {
   }
 
@@ -38,6 +46,7 @@ namespace app
   {
     QMutexLocker lock(&mutex);
     viewers.clear();
+    viewerIds.clear();
   }
 
   void MacroManager::loadPrototypes(const QStringList &dirs)
@@ -76,43 +85,101 @@ namespace app
         files.append(dirs[dindex] + '/' + dirFileList[findex]);
       }
     }
+#ifndef Q_OS_WIN
+    QRegularExpression regExp("(.*\\.so)(\\.\\d+){0,3}");
+    for(int findex = files.count() - 1; findex >= 0; --findex)
+    {
+      if (!regExp.match(files[findex]).hasMatch())
+      {
+        files.removeAt(findex);
+      }
+    }
+#endif
     emit loadPrototypesProgress(0,files.count(),tr("Loading macro library file %v of %m."));
-    for(int findex = 0; findex < files.count(); ++findex)
+    // Opening libraries and creating prototypes is done in parallel. Libraries are initialized and
+    // their elements registered in file order, so registration does not depend on thread timing.
+    // Libraries redirect std::cout and std::cerr on initialization, which requires this order, too.
+    // Libraries unchanged since their manifest was cached are neither opened nor initialized here.
+    ManifestCache cache = readManifestCache();
+    QList<LibraryFile> libs;
+    foreach(QString file, files)
     {
-#ifdef Q_OS_WIN
-      MacroLibrary* lib = new MacroLibraryDLL();
-      if (lib->load(files[findex],*this))
+      LibraryFile libFile = { file, new MacroLibraryDLL(), false };
+      QFileInfo fileInfo(file);
+      ManifestCache::const_iterator entry = cache.constFind(file);
+      if (entry != cache.constEnd() && entry->modified == fileInfo.lastModified().toMSecsSinceEpoch() && entry->size == fileInfo.size())
+      {
+        libFile.cached = libFile.library->restore(file,entry->manifest);
+      }
+      libs.append(libFile);
+    }
+    QMutex progressMutex;
+    QWaitCondition progressCondition;
+    int cntOpened = 0;
+    QFuture<void> opening = QtConcurrent::map(libs,[&](LibraryFile& libFile)
+    {
+      if (!libFile.cached && !libFile.library->open(libFile.path))
       {
-        cntMacros += lib->countMacros();
-        cntViewers += lib->countViewers();
-        libList.append(lib);
+        delete libFile.library;
+        libFile.library = 0;
+      }
+      QMutexLocker lock(&progressMutex);
+      ++cntOpened;
+      progressCondition.wakeOne();
+    });
+    // progress is reported by this thread only, so the values arrive in increasing order;
+    // this thread belongs to the pool as well and hands over its slot while waiting
+    QThreadPool::globalInstance()->releaseThread();
+    progressMutex.lock();
+    int cntReported = 0;
+    while(cntReported < libs.count())
+    {
+      while(cntOpened == cntReported)
+      {
+        progressCondition.wait(&progressMutex);
+      }
+      cntReported = cntOpened;
+      progressMutex.unlock();
+      emit loadPrototypesProgress(cntReported,files.count());
+      progressMutex.lock();
+    }
+    progressMutex.unlock();
+    opening.waitForFinished();
+    QThreadPool::globalInstance()->reserveThread();
+    QList<LibraryFile> initLibs;
+    foreach(const LibraryFile& libFile, libs)
+    {
+      if (libFile.library == 0) continue;
+      if (libFile.cached || libFile.library->initialize())
+      {
+        initLibs.append(libFile);
       }
       else
       {
-        delete lib;
+        delete libFile.library;
       }
-#else
-      QRegularExpression regExp("(.*\\.so)(\\.\\d+){0,3}");
-      if (regExp.match(files[findex]).hasMatch())
+    }
+    QtConcurrent::blockingMap(initLibs,[](LibraryFile& libFile) { libFile.library->createPrototypes(); });
+    unsigned int cntLibs = 0;
+    ManifestCache updatedCache;
+    foreach(const LibraryFile& libFile, initLibs)
+    {
+      if (libFile.library->registerPrototypes(*this))
       {
-        MacroLibrary* lib = new MacroLibraryDLL();
-        if (lib->load(files[findex],*this))
-        {
-          cntMacros += lib->countMacros();
-          cntViewers += lib->countViewers();
-          libList.append(lib);
-        }
-        else
-        {
-          delete lib;
-        }
+        cntMacros += libFile.library->countMacros();
+        cntViewers += libFile.library->countViewers();
+        ++cntLibs;
+        QFileInfo fileInfo(libFile.path);
+        ManifestEntry entry = { fileInfo.lastModified().toMSecsSinceEpoch(), fileInfo.size(), libFile.library->manifest() };
+        updatedCache.insert(libFile.path,entry);
       }
-#endif
-      emit loadPrototypesProgress(findex + 1,files.count());
+      // libraries without elements stay loaded until all are unloaded in reverse order
+      libList.append(libFile.library);
     }
-    if (libList.size() > 0)
+    writeManifestCache(updatedCache);
+    if (cntLibs > 0)
     {
-      if (libList.size() == 1)
+      if (cntLibs == 1)
       {
         switch(cntMacros + cntViewers)
         {
@@ -129,10 +196,10 @@ namespace app
         switch(cntMacros + cntViewers)
         {
         case 0:
-          syslog::warning(QString(QObject::tr("Loaded %1 libraries but no elements registered.")).arg(libList.size()),QObject::tr("Libraries"));
+          syslog::warning(QString(QObject::tr("Loaded %1 libraries but no elements registered.")).arg(cntLibs),QObject::tr("Libraries"));
           break;
         default:
-          syslog::info(QString(QObject::tr("Loaded %1 libraries. Registered macros: %2. Registered viewers: %3")).arg(libList.size()).arg(cntMacros).arg(cntViewers),QObject::tr("Libraries"));
+          syslog::info(QString(QObject::tr("Loaded %1 libraries. Registered macros: %2. Registered viewers: %3")).arg(cntLibs).arg(cntMacros).arg(cntViewers),QObject::tr("Libraries"));
           break;
         }
       }
@@ -149,9 +216,12 @@ namespace app
   {
     QMutexLocker lock(&mutex);
     viewers.clear();
+    viewerIds.clear();
     clear();
     // It is crucial to release loaded libraries in reverse order because libraries redirect std:cout and std::cerr.
-    // Their previous addresses have to be restored in correct order.
+    // Their previous addresses have to be restored in correct order. Libraries restored from the manifest cache
+    // are initialized on first use, so the order of initialization may differ from the order in the list.
+    std::stable_sort(libList.begin(),libList.end(),initializedBefore);
     while(!libList.empty())
     {
       delete libList.last();
@@ -159,28 +229,99 @@ namespace app
     }
   }
 
+  bool MacroManager::initializedBefore(const MacroLibraryDLL* lib1, const MacroLibraryDLL* lib2)
+  {
+    return lib1->initializationOrder() < lib2->initializationOrder();
+  }
+
+  MacroManager::ManifestCache MacroManager::readManifestCache() const
+  {
+    ManifestCache cache;
+    if (manifestFile.isEmpty())
+    {
+      return cache;
+    }
+    QFile file(manifestFile);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+      return cache;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+    if (magic != 0x494D4D43 || version != 2)
+    {
+      return cache;
+    }
+    for(quint32 index = 0; index < count && stream.status() == QDataStream::Ok; ++index)
+    {
+      QString path;
+      ManifestEntry entry;
+      stream >> path >> entry.modified >> entry.size >> entry.manifest;
+      cache.insert(path,entry);
+    }
+    if (stream.status() != QDataStream::Ok)
+    {
+      syslog::warning(QString(QObject::tr("Macro library cache '%1' is corrupt. Libraries are reloaded.")).arg(QDir::toNativeSeparators(manifestFile)),QObject::tr("Libraries"));
+      cache.clear();
+    }
+    return cache;
+  }
+
+  void MacroManager::writeManifestCache(const ManifestCache& cache) const
+  {
+    if (manifestFile.isEmpty())
+    {
+      return;
+    }
+    QSaveFile file(manifestFile);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+      syslog::warning(QString(QObject::tr("Macro library cache '%1' could not be written.")).arg(QDir::toNativeSeparators(manifestFile)),QObject::tr("Libraries"));
+      return;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << quint32(0x494D4D43) << quint32(2) << quint32(cache.count());
+    for(ManifestCache::const_iterator it = cache.constBegin(); it != cache.constEnd(); ++it)
+    {
+      stream << it.key() << it->modified << it->size << it->manifest;
+    }
+    if (!file.commit())
+    {
+      syslog::warning(QString(QObject::tr("Macro library cache '%1' could not be written.")).arg(QDir::toNativeSeparators(manifestFile)),QObject::tr("Libraries"));
+    }
+  }
+
   bool MacroManager::registerMacroViewer(MacroViewer::Ptr viewer)
   {
     QMutexLocker lock(&mutex);
     if (!viewer.isNull())
     {
+      // viewers are listed in the order of their type names, looked up by type id
       foreach(QString typeSignature,viewer->dataTypes())
       {
         viewers.insert(typeSignature,viewer);
       }
+      foreach(quint64 typeId,viewer->dataTypeIds())
+      {
+        viewerIds.insert(typeId,viewer);
+      }
       return true;
     }
     return false;
   }
 
-  MacroViewer::Ptr MacroManager::createMacroViewerInstance(const QString &dataType)
+  MacroViewer::Ptr MacroManager::createMacroViewerInstance(quint64 dataTypeId)
   {
     QMutexLocker lock(&mutex);
-    if (!viewers.contains(dataType))
+    ViewerIdMap::const_iterator it = viewerIds.constFind(dataTypeId);
+    if (it == viewerIds.constEnd())
     {
       return MacroViewer::Ptr();
     }
-    MacroViewer::Ptr viewerPtr = viewers.value(dataType);
+    MacroViewer::Ptr viewerPtr = it.value();
     return viewerPtr->clone().staticCast<MacroViewer>();
   }
 
@@ -27,6 +27,7 @@
 #include <QList>
 #include <QStringList>
 #include <QMultiMap>
+#include <QHash>
 
 namespace app
 {
@@ -44,12 +45,21 @@ namespace app
     void loadPrototypes(const QStringList& dirs);
     void unloadPrototypes();
 
+    /**
+     * Sets the file caching the manifests of loaded libraries. Libraries unchanged since they were
+     * cached are registered from their manifest and loaded on first use. An empty name disables the cache.
+     */
+    void setManifestCache(const QString& fileName)
+    {
+      manifestFile = fileName;
+    }
+
     bool registerMacroViewer(MacroViewer::Ptr viewer);
-    MacroViewer::Ptr createMacroViewerInstance(const QString& dataType);
+    MacroViewer::Ptr createMacroViewerInstance(quint64 dataTypeId);
 
-    bool hasMacroViewer(const QString& dataType) const
+    bool hasMacroViewer(quint64 dataTypeId) const
     {
-      return viewers.contains(dataType);
+      return viewerIds.contains(dataTypeId);
     }
 
     void iterateViewerTypes(IteratorFunction iterator, ... ) const;
@@ -69,11 +79,33 @@ namespace app
 
     static MacroManager macroManager;
 
-    typedef QList<MacroLibrary*> LibraryList;
+    struct LibraryFile
+    {
+      QString          path;
+      MacroLibraryDLL* library;
+      bool             cached;
+    };
+
+    struct ManifestEntry
+    {
+      qint64     modified;
+      qint64     size;
+      QByteArray manifest;
+    };
+
+    typedef QList<MacroLibraryDLL*> LibraryList;
     typedef QMultiMap<QString, MacroViewer::Ptr> ViewerMap;
+    typedef QHash<quint64, MacroViewer::Ptr> ViewerIdMap;
+    typedef QHash<QString, ManifestEntry> ManifestCache;
+
+    ManifestCache readManifestCache() const;
+    void writeManifestCache(const ManifestCache& cache) const;
+    static bool initializedBefore(const MacroLibraryDLL* lib1, const MacroLibraryDLL* lib2);
 
     LibraryList          libList;
     ViewerMap            viewers;
+    ViewerIdMap          viewerIds;
+    QString              manifestFile;
   };
 
 }
@@ -22,87 +22,549 @@
 #include "appprocessgraph.h"
 #include "appmacro.h"
 #include "sysloglogger.h"
-#include <QtConcurrent/QtConcurrent>
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
 
 namespace app
 {
   //-----------------------------------------------------------------------
   // Class ProcessGraph
   //-----------------------------------------------------------------------
+  bool ProcessGraph::saveRuntimeStatistics(const QString& fileName) const
+  {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+      syslog::error(QString(QObject::tr("Cannot write runtime statistics to file '%1'.")).arg(QDir::toNativeSeparators(fileName)),QObject::tr("Process Graph"));
+      return false;
+    }
+    // all times are given in micro seconds
+    static const double percentiles[] = { 50.0, 95.0, 99.0 };
+    bool json = QFileInfo(fileName).suffix().compare("json",Qt::CaseInsensitive) == 0;
+    QJsonArray macros;
+    QTextStream csv(&file);
+    if (!json)
+    {
+      csv << "id,name,count,mean,min,p50,p95,p99,max,total\n";
+    }
+    foreach(graph::Vertex::Ptr vertex,vertexList())
+    {
+      const Macro::Ptr macro = vertex->dataRef().staticCast<Macro>();
+      const LatencyHistogram& histogram = macro->getRuntimeHistogram();
+      qint64 values[3];
+      for(int i = 0; i < 3; ++i)
+      {
+        values[i] = histogram.percentile(percentiles[i]);
+      }
+      if (json)
+      {
+        QJsonObject entry;
+        entry["id"] = vertex->id().toString();
+        entry["name"] = macro->getName();
+        entry["count"] = histogram.count();
+        entry["mean"] = histogram.mean();
+        entry["min"] = histogram.min();
+        entry["p50"] = values[0];
+        entry["p95"] = values[1];
+        entry["p99"] = values[2];
+        entry["max"] = histogram.max();
+        entry["total"] = histogram.total();
+        macros.append(entry);
+      }
+      else
+      {
+        QString macroName = macro->getName();
+        macroName.replace('"',"\"\"");
+        csv << vertex->id().toString() << ",\"" << macroName << "\"," << histogram.count() << ',' << QString::number(histogram.mean(),'f',3) << ','
+            << histogram.min() << ',' << values[0] << ',' << values[1] << ',' << values[2] << ',' << histogram.max() << ',' << histogram.total() << '\n';
+      }
+    }
+    if (json)
+    {
+      QJsonObject root;
+      root["graph"] = name();
+      root["unit"] = QString("us");
+      root["macros"] = macros;
+      file.write(QJsonDocument(root).toJson());
+    }
+    csv.flush();
+    return file.error() == QFileDevice::NoError;
+  }
+
+  void ProcessGraph::updateCriticalPath()
+  {
+    // longest path in topological order; edges closing a cycle do not delay their destination within a frame
+    QHash<graph::Vertex*,qint64> finish;
+    QHash<graph::Vertex*,graph::Edge::Ptr> critical;
+    graph::Vertex* last = 0;
+    longestPath = CriticalPath();
+    const graph::GraphBase::ComponentMap& order = topologicalOrder();
+    for(graph::GraphBase::ComponentMap::const_iterator it = order.begin(); it != order.end(); ++it)
+    {
+      if (it.key() < 0) continue;
+      graph::Vertex* vertex = it.value().data();
+      qint64 start = 0;
+      foreach(graph::Edge::Ptr edgeRef,vertex->edges(graph::Defines::Incoming))
+      {
+        graph::Vertex* src = &edgeRef->srcPin()->vertex();
+        if (src->topologicalOrder() < 0 || src->topologicalOrder() >= vertex->topologicalOrder()) continue;
+        if (!critical.contains(vertex) || finish.value(src) > start)
+        {
+          start = finish.value(src);
+          critical.insert(vertex,edgeRef);
+        }
+      }
+      qint64 end = start + qRound64(vertex->dataRef().staticCast<Macro>()->getRuntimeHistogram().mean());
+      finish.insert(vertex,end);
+      if (last == 0 || end > finish.value(last))
+      {
+        last = vertex;
+      }
+    }
+    if (last == 0) return;
+    longestPath.length = finish.value(last);
+    // walk back along the edges which determined the start of each macro
+    while(last != 0)
+    {
+      longestPath.vertices.insert(last->id());
+      graph::Edge::Ptr edgeRef = critical.value(last);
+      if (edgeRef.isNull()) break;
+      longestPath.edges.insert(edgeRef->id());
+      last = &edgeRef->srcPin()->vertex();
+    }
+  }
+
+  bool ProcessGraph::saveTrace(const QString& fileName) const
+  {
+    if (recorder.isEmpty())
+    {
+      syslog::warning(QString(QObject::tr("%1: No timeline recorded. Enable 'Record timeline' and run the graph first.")).arg(name()),QObject::tr("Process Graph"));
+      return false;
+    }
+    if (!recorder.save(fileName))
+    {
+      syslog::error(QString(QObject::tr("Cannot write timeline to file '%1'.")).arg(QDir::toNativeSeparators(fileName)),QObject::tr("Process Graph"));
+      return false;
+    }
+    return true;
+  }
+
+  //-----------------------------------------------------------------------
+  // Class PGExecutionPlan
+  //-----------------------------------------------------------------------
+  PGExecutionPlan::PGExecutionPlan() : nodes(), successors(), predecessors(), links(), feedback(false), fused(0)
+  {
+  }
+
+  bool PGExecutionPlan::compile(const graph::GraphBase::ComponentMap& componentVertices, bool fuseChains)
+  {
+    nodes.clear();
+    successors.clear();
+    predecessors.clear();
+    links.clear();
+    feedback = false;
+    fused = 0;
+    if (componentVertices.isEmpty() || componentVertices.begin().value()->graph().isNull()) return false;
+    // assign dense indices to all vertices in topological order and map the graph's vertex indices onto them
+    graph::Adjacency::Ptr snapshot = componentVertices.begin().value()->graph()->adjacency();
+    QVector<int> indexMap(snapshot->countVertices(),-1);
+    QVector<int> graphIndex;
+    for(graph::GraphBase::ComponentMap::const_iterator it = componentVertices.begin(); it != componentVertices.end(); ++it)
+    {
+      if (it.key() < 0) return false;
+      int index = snapshot->index(it.value().data());
+      if (index < 0) return false;
+      Node node;
+      node.vertex = it.value().data();
+      node.macro = it.value()->dataRef().staticCast<app::Macro>().data();
+      node.outputSlots = 0;
+      node.succBegin = node.succEnd = node.predBegin = node.predEnd = node.linkBegin = node.linkEnd = 0;
+      node.chainNext = -1;
+      indexMap[index] = nodes.size();
+      graphIndex.append(index);
+      nodes.append(node);
+    }
+    // Only edges pointing to a vertex with higher topological order are dependencies within a frame.
+    // Edges closing a cycle deliver data of the previous frame and do not block the destination vertex.
+    QVector<QVector<int> > predList(nodes.size());
+    for(int i = 0; i < nodes.size(); ++i)
+    {
+      Node& node = nodes[i];
+      node.succBegin = successors.size();
+      for(int pos = snapshot->succBegin(graphIndex[i]); pos < snapshot->succEnd(graphIndex[i]); ++pos)
+      {
+        int j = indexMap[snapshot->successor(pos)];
+        if (j < 0) continue;
+        if (nodes[j].vertex->topologicalOrder() > node.vertex->topologicalOrder())
+        {
+          successors.append(j);
+          predList[j].append(i);
+          // the output with the fewest slots read by a successor limits how far this node may run ahead
+          MacroOutput::Ptr output = snapshot->outEdge(pos)->srcPin()->dataRef().staticCast<MacroOutput>();
+          int slots = (output.isNull()) ? 1 : output->getSlotCount();
+          if (node.outputSlots == 0 || slots < node.outputSlots)
+          {
+            node.outputSlots = slots;
+          }
+        }
+        else
+        {
+          feedback = true;
+        }
+      }
+      node.succEnd = successors.size();
+      if (node.outputSlots == 0)
+      {
+        node.outputSlots = 1;
+      }
+      // the single successor of a linear chain runs in the same task as this node
+      if (fuseChains && node.succEnd - node.succBegin == 1 && node.vertex->linearChain() >= 0 &&
+          node.vertex->linearChain() == nodes[successors[node.succBegin]].vertex->linearChain())
+      {
+        node.chainNext = successors[node.succBegin];
+        fused++;
+      }
+      // inputs connected to a multi-buffered output are redirected to the right slot for every frame
+      node.linkBegin = links.size();
+      for(int pos = snapshot->predBegin(graphIndex[i]); pos < snapshot->predEnd(graphIndex[i]); ++pos)
+      {
+        graph::Edge* edgeRef = snapshot->inEdge(pos);
+        MacroOutput::Ptr output = edgeRef->srcPin()->dataRef().staticCast<MacroOutput>();
+        MacroInput::Ptr input = edgeRef->destPin()->dataRef().staticCast<MacroInput>();
+        if (!output.isNull() && !input.isNull() && output->getSlotCount() > 1)
+        {
+          // edges closing a cycle deliver the result of the previous frame
+          bool isFeedback = edgeRef->srcPin()->vertex().topologicalOrder() >= node.vertex->topologicalOrder();
+          DataLink link = { input.data(), output.data(), (isFeedback) ? output->getSlotCount() - 1 : 0 };
+          links.append(link);
+        }
+      }
+      node.linkEnd = links.size();
+    }
+    for(int i = 0; i < nodes.size(); ++i)
+    {
+      nodes[i].predBegin = predecessors.size();
+      predecessors += predList[i];
+      nodes[i].predEnd = predecessors.size();
+    }
+    return !nodes.isEmpty();
+  }
 
   //-----------------------------------------------------------------------
   // Class PGComponentHandler
   //-----------------------------------------------------------------------
-  PGComponentHandler::PGComponentHandler(ProcessGraphCtrl* ctrl, graph::GraphBase::ComponentMap &componentVertices) : QObject(0),
-    vertices(componentVertices), controller(ctrl), maxOrder(componentVertices.uniqueKeys().size()), currentOrder(0), init(true), compWatcher()
+  PGComponentHandler::PGComponentHandler(ProcessGraphCtrl* ctrl, graph::GraphBase::ComponentMap &componentVertices, TaskExecutor& taskExecutor, int pipelineDepth, bool fuseChains, TraceRecorder* traceRecorder) : QObject(0),
+    vertices(componentVertices), controller(ctrl), executor(taskExecutor), trace(traceRecorder), plan(), framesDone(), nodeRunning(), frameNodeCount(), frameBegin(), depth(1), maxFrames(ctrl->maxFrames()), frameLimit(0), framesStarted(0),
+    framesFinished(0), tasksRunning(0), stopsPending(0), stopResult(0), running(false), paused(false), canceled(false), stopping(false), notifyPending(false), overheadNsecs(0), runClock(), initDoneNsecs(0), lastFrameNsecs(0),
+    mutex()
   {
     Q_ASSERT(ctrl != 0);
-    connect(ctrl,SIGNAL(paused(bool)),&compWatcher,SLOT(setPaused(bool)));
-    connect(ctrl,SIGNAL(abortComputation()),&compWatcher,SLOT(cancel()));
-    connect(&compWatcher,SIGNAL(finished()),ctrl,SLOT(continueProcessing()));
+    connect(ctrl,SIGNAL(paused(bool)),this,SLOT(setPaused(bool)));
+    connect(ctrl,SIGNAL(abortComputation()),this,SLOT(cancel()));
+    connect(this,SIGNAL(frameFinished()),ctrl,SLOT(continueProcessing()));
+    connect(this,SIGNAL(macroStopped(int)),ctrl,SLOT(requestStop(int)));
+    connect(this,SIGNAL(componentStopped(int)),ctrl,SLOT(terminateProcessing(int)));
+    plan.compile(vertices,fuseChains);
+    // frames may only overlap if there is no feedback from the previous frame
+    if (!plan.hasFeedback() && pipelineDepth > 1)
+    {
+      depth = pipelineDepth;
+    }
+    framesDone.fill(0,plan.size());
+    nodeRunning.fill(false,plan.size());
+    frameNodeCount.fill(0,depth);
+    frameBegin.fill(0,depth);
   }
 
   bool PGComponentHandler::isRunnable()
   {
-    return (maxOrder > 0 && !vertices.uniqueKeys().contains(-1));
+    return (plan.size() > 0 && plan.size() == vertices.size());
+  }
+
+  int PGComponentHandler::frames() const
+  {
+    QMutexLocker lock(&mutex);
+    return framesFinished;
+  }
+
+  qint64 PGComponentHandler::frameTime() const
+  {
+    // the initialization frame is not taken into account
+    QMutexLocker lock(&mutex);
+    return (framesFinished > 1) ? (lastFrameNsecs - initDoneNsecs) / (framesFinished - 1) : 0;
+  }
+
+  qint64 PGComponentHandler::schedulerOverhead() const
+  {
+    QMutexLocker lock(&mutex);
+    return overheadNsecs;
   }
 
   void PGComponentHandler::runNext(bool snap, bool stop)
   {
-    if (currentOrder == maxOrder)
+    QMutexLocker lock(&mutex);
+    notifyPending = false;
+    // once the exit pass has begun, late notifications must neither stop nor restart processing
+    if (stopping) return;
+    if (!running && !stop)
+    {
+      // start processing with initialization frame
+      running = true;
+      runClock.start();
+      frameLimit = depth;
+    }
+    else if (stop)
     {
-      currentOrder = 0;
-      if (!init && snap) stop = true;
-      init = false;
+      canceled = true;
     }
-    if (stop)
+    else if (snap && framesFinished > 1)
     {
-      disconnect(&compWatcher,SIGNAL(finished()),controller,SLOT(continueProcessing()));
-      connect(&compWatcher,SIGNAL(finished()),controller,SLOT(terminateProcessing()));
-      QFuture<int> compResult = QtConcurrent::mappedReduced(vertices.values(),stopFunctor,collectResults);
-      compWatcher.setFuture(compResult);
+      // do not start any new frames but finish frames already in progress
+      frameLimit = framesStarted;
+    }
+    else
+    {
+      frameLimit = framesFinished + depth;
+    }
+    if (maxFrames > 0 && frameLimit > maxFrames)
+    {
+      frameLimit = maxFrames;
+    }
+    if (tasksRunning == 0 && (canceled || framesFinished == frameLimit))
+    {
+      running = false;
+      stopping = true;
+      // exit methods run on the workers of this graph like all other macro methods
+      stopsPending = vertices.size();
+      stopResult = 0;
+      foreach(graph::Vertex::Ptr vertex, vertices)
+      {
+        executor.submit([this, vertex]()
+        {
+          stopNode(vertex);
+        });
+      }
     }
     else
     {
-      QFuture<int> compResult = QtConcurrent::mappedReduced(vertices.values(currentOrder),(init) ? startFunctor : applyFunctor,collectResults);
-      compWatcher.setFuture(compResult);
-      currentOrder++;
+      scheduleAll();
     }
   }
 
-  int PGComponentHandler::applyFunctor(graph::Vertex::Ptr vertex)
+  void PGComponentHandler::setPaused(bool pauseOn)
   {
-    app::Macro::Ptr macro = vertex->dataRef().staticCast<app::Macro>();
-    int result = macro->apply();
+    QMutexLocker lock(&mutex);
+    paused = pauseOn;
+    if (!paused && running)
+    {
+      scheduleAll();
+    }
+  }
+
+  void PGComponentHandler::cancel()
+  {
+    mutex.lock();
+    if (!running || canceled || stopping)
+    {
+      mutex.unlock();
+      return;
+    }
+    canceled = true;
+    // an idle component needs a notification to start its exit pass unless one is already queued
+    bool notify = (tasksRunning == 0 && !notifyPending);
+    notifyPending = notifyPending || notify;
+    mutex.unlock();
+    if (notify)
+    {
+      emit frameFinished();
+    }
+  }
+
+  void PGComponentHandler::scheduleAll()
+  {
+    for(int i = 0; i < plan.size(); ++i)
+    {
+      tryDispatch(i);
+    }
+  }
+
+  int PGComponentHandler::claimNode(int index)
+  {
+    // the caller holds the lock
+    if (!running || canceled || paused || nodeRunning[index]) return -1;
+    const PGExecutionPlan::Node& node = plan.nodes[index];
+    int frame = framesDone[index];
+    if (frame >= frameLimit) return -1;
+    // all predecessors must have delivered their results for this frame
+    for(int i = node.predBegin; i < node.predEnd; ++i)
+    {
+      if (framesDone[plan.predecessors[i]] <= frame) return -1;
+    }
+    // all successors must have consumed the output which is going to be overwritten
+    for(int i = node.succBegin; i < node.succEnd; ++i)
+    {
+      if (framesDone[plan.successors[i]] < frame - node.outputSlots + 1) return -1;
+    }
+    nodeRunning[index] = true;
+    tasksRunning++;
+    if (frame + 1 > framesStarted)
+    {
+      framesStarted = frame + 1;
+      if (trace) frameBegin[frame % depth] = trace->now();
+    }
+    // hand over output slots of this frame to the macro and its consumers
+    for(int i = node.linkBegin; i < node.linkEnd; ++i)
+    {
+      const PGExecutionPlan::DataLink& link = plan.links[i];
+      link.input->setDataPtr(*link.output,frame + link.frameOffset);
+    }
+    node.macro->selectFrame(frame);
+    return frame;
+  }
+
+  bool PGComponentHandler::tryDispatch(int index)
+  {
+    int frame = claimNode(index);
+    if (frame < 0) return false;
+    executor.submit([this, index, frame]()
+    {
+      runNode(index,frame);
+    });
+    return true;
+  }
+
+  void PGComponentHandler::runNode(int index, int frame)
+  {
+    // macros of a fused chain are executed one after another in this task
+    while(index >= 0)
+    {
+      const PGExecutionPlan::Node& node = plan.nodes[index];
+      MacroFunction function = (frame == 0) ? startMacro : applyMacro;
+      qint64 begin = (trace) ? trace->now() : 0;
+      int result = function(*node.macro,*node.vertex);
+      if (trace) trace->complete(node.macro->getName(),(frame == 0) ? "init" : "apply",begin,frame);
+      index = nodeFinished(index,result,frame);
+    }
+  }
+
+  int PGComponentHandler::nodeFinished(int index, int result, int& nextFrame)
+  {
+    // executed in worker thread: successors are started directly from here
+    QElapsedTimer timer;
+    timer.start();
+    qint64 begin = (trace) ? trace->now() : 0;
+    bool stopRequest = false;
+    bool notify = false;
+    int nextIndex = -1;
+    mutex.lock();
+    int frame = framesDone[index]++;
+    nodeRunning[index] = false;
+    tasksRunning--;
+    if (result > 0 && !canceled)
+    {
+      // controller sets stop flag and cancels all components
+      canceled = true;
+      stopRequest = true;
+    }
+    if (++frameNodeCount[frame % depth] == plan.size())
+    {
+      frameNodeCount[frame % depth] = 0;
+      framesFinished++;
+      notify = true;
+      if (frame == 0)
+      {
+        initDoneNsecs = runClock.nsecsElapsed();
+      }
+      else
+      {
+        lastFrameNsecs = runClock.nsecsElapsed();
+      }
+      if (trace) trace->span(QString("Frame %1").arg(frame),"frame",frameBegin[frame % depth],frame);
+    }
+    if (canceled)
+    {
+      notify = notify || tasksRunning == 0;
+    }
+    else
+    {
+      const PGExecutionPlan::Node& node = plan.nodes[index];
+      // continue with next macro of fused chain in this thread
+      if (node.chainNext >= 0)
+      {
+        nextFrame = claimNode(node.chainNext);
+        if (nextFrame >= 0) nextIndex = node.chainNext;
+      }
+      // node itself, its successors and its predecessors might be ready now
+      tryDispatch(index);
+      for(int i = node.succBegin; i < node.succEnd; ++i)
+      {
+        tryDispatch(plan.successors[i]);
+      }
+      for(int i = node.predBegin; i < node.predEnd; ++i)
+      {
+        tryDispatch(plan.predecessors[i]);
+      }
+    }
+    // only one notification is queued at a time, the controller evaluates the latest state anyway
+    notify = notify && !notifyPending && !stopping;
+    notifyPending = notifyPending || notify;
+    overheadNsecs += timer.nsecsElapsed();
+    mutex.unlock();
+    if (trace) trace->complete(QObject::tr("Schedule"),"scheduler",begin,frame);
+    if (stopRequest) emit macroStopped(result);
+    if (notify) emit frameFinished();
+    return nextIndex;
+  }
+
+  void PGComponentHandler::stopNode(graph::Vertex::Ptr vertex)
+  {
+    int result = stopFunctor(vertex);
+    mutex.lock();
+    collectResults(stopResult,result);
+    bool done = (--stopsPending == 0);
+    result = stopResult;
+    mutex.unlock();
+    if (done) emit componentStopped(result);
+  }
+
+  int PGComponentHandler::applyMacro(Macro& macro, const graph::Vertex& vertex)
+  {
+    int result = macro.apply();
     if (result == 2)
     {
-      QString msg = QString(QObject::tr("%2: Error returned in method 'apply' of macro '%1'.")).arg(macro->getName()).arg(vertex->graph()->name());
-      QString macroMsg = macro->getErrorMsg();
+      QString msg = QString(QObject::tr("%2: Error returned in method 'apply' of macro '%1'.")).arg(macro.getName()).arg(vertex.graph()->name());
+      QString macroMsg = macro.getErrorMsg();
       if (!macroMsg.isEmpty()) msg += '\n' + macroMsg;
       syslog::error(msg,QObject::tr("Process Graph"));
     }
     else if (result == 1)
     {
-      syslog::info(QString(QObject::tr("%2: Method 'apply' of macro '%1' stops processing.")).arg(macro->getName()).arg(vertex->graph()->name()),QObject::tr("Process Graph"));
+      syslog::info(QString(QObject::tr("%2: Method 'apply' of macro '%1' stops processing.")).arg(macro.getName()).arg(vertex.graph()->name()),QObject::tr("Process Graph"));
     }
     return result;
   }
 
-  int PGComponentHandler::startFunctor(graph::Vertex::Ptr vertex)
+  int PGComponentHandler::startMacro(Macro& macro, const graph::Vertex& vertex)
   {
-    app::Macro::Ptr macro = vertex->dataRef().staticCast<app::Macro>();
-    int result = macro->start();
+    int result = macro.start();
     if (result == 2)
     {
-      QString msg = QString(QObject::tr("%2: Error returned in method 'init' of macro '%1'.")).arg(macro->getName()).arg(vertex->graph()->name());
-      QString macroMsg = macro->getErrorMsg();
+      QString msg = QString(QObject::tr("%2: Error returned in method 'init' of macro '%1'.")).arg(macro.getName()).arg(vertex.graph()->name());
+      QString macroMsg = macro.getErrorMsg();
       if (!macroMsg.isEmpty()) msg += '\n' + macroMsg;
       syslog::error(msg,QObject::tr("Process Graph"));
     }
     else if (result == 1)
     {
-      syslog::info(QString(QObject::tr("%2: Method 'init' of macro '%1' stops processing.")).arg(macro->getName()).arg(vertex->graph()->name()),QObject::tr("Process Graph"));
+      syslog::info(QString(QObject::tr("%2: Method 'init' of macro '%1' stops processing.")).arg(macro.getName()).arg(vertex.graph()->name()),QObject::tr("Process Graph"));
     }
     return result;
   }
@@ -110,7 +572,11 @@ namespace app
   int PGComponentHandler::stopFunctor(graph::Vertex::Ptr vertex)
   {
     app::Macro::Ptr macro = vertex->dataRef().staticCast<app::Macro>();
+    ProcessGraph* pg = qobject_cast<ProcessGraph*>(vertex->graph().data());
+    TraceRecorder* trace = (pg != 0 && pg->tracing()) ? &pg->trace() : 0;
+    qint64 begin = (trace) ? trace->now() : 0;
     int result = macro->stop();
+    if (trace) trace->complete(macro->getName(),"exit",begin);
     if (result == 2)
     {
       QString msg = QString(QObject::tr("%2: Error returned in method 'exit' of macro '%1'.")).arg(macro->getName()).arg(vertex->graph()->name());
@@ -135,8 +601,8 @@ namespace app
   //-----------------------------------------------------------------------
   int ProcessGraphCtrl::InitProcessing = QEvent::registerEventType(QEvent::User + 2);
 
-  ProcessGraphCtrl::ProcessGraphCtrl(ProcessGraph& pg) : QObject(0), processGraph(pg), components(), flagError(false),
-    flagPause(false), flagSnap(false), flagStop(false), compCounter(0)
+  ProcessGraphCtrl::ProcessGraphCtrl(ProcessGraph& pg) : QObject(0), processGraph(pg), components(), executor(0), trace(0), flagError(false),
+    flagPause(false), flagSnap(false), flagStop(false), compCounter(0), frameCount(0)
   {
   }
 
@@ -165,6 +631,7 @@ namespace app
   void ProcessGraphCtrl::pause()
   {
     flagPause = !flagPause;
+    if (trace) trace->instant((flagPause) ? tr("Pause") : tr("Resume"),"control");
     emit paused(flagPause);
   }
 
@@ -180,6 +647,7 @@ namespace app
       flagPause = false;
       emit paused(flagPause);
     }
+    if (trace) trace->instant(tr("Stop"),"control");
     flagStop = true;
     emit abortComputation();
   }
@@ -187,8 +655,16 @@ namespace app
   void ProcessGraphCtrl::initProcessing()
   {
     syslog::info(QString(tr("%1: Start processing.")).arg(processGraph.name()),QObject::tr("Process Graph"));
+    if (processGraph.tracing())
+    {
+      trace = &processGraph.trace();
+      trace->start();
+      trace->nameThread(tr("Controller"));
+    }
+    qint64 begin = (trace) ? trace->now() : 0;
     const graph::GraphBase::ComponentMap componentVertices = processGraph.components();
-    int compCount = componentVertices.uniqueKeys().size();
+    executor = new TaskExecutor(processGraph.workerCount());
+    int compCount = processGraph.countComponents();
     int index = 0;
     while(index < compCount && !flagError)
     {
@@ -198,10 +674,14 @@ namespace app
       {
         comp.insert(vertex->topologicalOrder(),vertex);
       }
-      PGComponentHandler* handler = new PGComponentHandler(this,comp);
+      PGComponentHandler* handler = new PGComponentHandler(this,comp,*executor,(processGraph.pipelined()) ? processGraph.pipelineDepth() : 1,processGraph.fuseChains(),trace);
       if (handler && handler->isRunnable())
       {
         components.insert(handler->id(),handler);
+        if (processGraph.pipelined() && handler->hasFeedback())
+        {
+          syslog::warning(QString(tr("%1: Component %2 contains cycles. Pipelined execution is disabled for this component.")).arg(processGraph.name()).arg(index + 1),QObject::tr("Process Graph"));
+        }
       }
       else
       {
@@ -210,6 +690,7 @@ namespace app
       ++index;
     }
 
+    if (trace) trace->complete(tr("Initialize"),"control",begin);
     // If graph contains no macros or not yet sorted macros, stop processing
     if (flagError || components.isEmpty())
     {
@@ -225,23 +706,27 @@ namespace app
 
   void ProcessGraphCtrl::continueProcessing()
   {
-    QFutureWatcher<int>* watcher = dynamic_cast< QFutureWatcher<int>* >(sender());
-    unsigned long long id = reinterpret_cast<unsigned long long>(watcher);
-    QFuture<int> future = watcher->future();
-    if ((future.resultCount() == 0 || future.result() > 0) && !future.isCanceled())
+    PGComponentHandler* handler = qobject_cast<PGComponentHandler*>(sender());
+    Q_ASSERT(handler != 0);
+    qint64 begin = (trace) ? trace->now() : 0;
+    handler->runNext(flagSnap,flagStop);
+    if (trace) trace->complete(tr("Continue"),"control",begin,handler->frames());
+  }
+
+  void ProcessGraphCtrl::requestStop(int result)
+  {
+    if (result > 1) flagError = true;
+    if (trace) trace->instant(tr("Stop requested"),"control");
+    if (!flagStop)
     {
-      if (future.result() > 1) flagError = true;
       flagStop = true;
       emit abortComputation();
     }
-    components[id]->runNext(flagSnap,flagStop);
   }
 
-  void ProcessGraphCtrl::terminateProcessing()
+  void ProcessGraphCtrl::terminateProcessing(int result)
   {
-    QFutureWatcher<int>* watcher = dynamic_cast< QFutureWatcher<int>* >(sender());
-    QFuture<int> future = watcher->future();
-    if (future.resultCount() == 0 || future.result() > 1)
+    if (result > 1)
     {
       flagError = true;
     }
@@ -263,12 +748,36 @@ namespace app
     {
       syslog::info(QString(tr("%1: Stopped processing.")).arg(processGraph.name()),QObject::tr("Process Graph"));
     }
-    // delete handler for graph components
+    // shut down workers first, they might still return from the last task of a handler
+    if (executor)
+    {
+      TaskExecutor::Statistics stats = executor->statistics();
+      syslog::info(QString(tr("%1: %2 worker threads executed %3 tasks, %4 stolen, %5 ms idle.")).arg(processGraph.name()).arg(stats.workers)
+                   .arg(stats.tasks).arg(stats.steals).arg(stats.idleNsecs / 1000000),QObject::tr("Process Graph"));
+      delete executor;
+      executor = 0;
+    }
+    // delete handler for graph components; components run side by side, so the slowest one determines the frame time
+    qint64 frameTime = 0;
     for(GraphComponentMap::iterator it = components.begin(); it != components.end(); ++it)
     {
+      frameTime = qMax(frameTime,it.value()->frameTime());
+      int frames = it.value()->frames();
+      if (frames > 0)
+      {
+        syslog::info(QString(tr("%1: Scheduler overhead of component %2: %3 us per frame.")).arg(processGraph.name()).arg(it.key())
+                     .arg(double(it.value()->schedulerOverhead()) / (1000.0 * frames),0,'f',1),QObject::tr("Process Graph"));
+      }
       delete it.value();
     }
     components.clear();
+    processGraph.setObservedFrameTime(frameTime / 1000);
+    if (trace)
+    {
+      trace->instant(tr("Clean up"),"control");
+      trace->stop();
+      trace = 0;
+    }
     flagSnap = false;
     flagPause = false;
     flagStop = false;
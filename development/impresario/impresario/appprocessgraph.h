@@ -22,49 +22,300 @@
 #define APPPROCESSGRAPH_H
 
 #include "graphmain.h"
+#include "appexecutor.h"
+#include "apptrace.h"
 #include <QObject>
-#include <QFutureWatcher>
 #include <QEvent>
+#include <QVector>
+#include <QList>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QUuid>
 
 namespace app
 {
+  class MacroInput;
+  class MacroOutput;
+
   class ProcessGraph : public graph::DirectedGraph
   {
     Q_OBJECT
+    Q_PROPERTY(bool pipelined READ pipelined WRITE setPipelined RESET resetPipelined)
+    Q_PROPERTY(int pipelineDepth READ pipelineDepth WRITE setPipelineDepth RESET resetPipelineDepth)
+    Q_PROPERTY(int workerCount READ workerCount WRITE setWorkerCount RESET resetWorkerCount)
+    Q_PROPERTY(bool fuseChains READ fuseChains WRITE setFuseChains RESET resetFuseChains)
+    Q_PROPERTY(bool tracing READ tracing WRITE setTracing STORED false)
+    Q_PROPERTY(bool criticalPathShown READ criticalPathShown WRITE showCriticalPath STORED false)
   public:
-    ProcessGraph()
+    // longest chain of dependent macros weighted with their mean runtime in micro seconds
+    struct CriticalPath
+    {
+      CriticalPath() : vertices(), edges(), length(0) {}
+      QSet<QUuid> vertices;
+      QSet<QUuid> edges;
+      qint64      length;
+    };
+
+    ProcessGraph() : graph::DirectedGraph(), pipelineOn(false), pipelineFrames(2), workers(0), fusionOn(true), tracingOn(false), recorder(),
+      criticalPathOn(false), longestPath(), frameTime(0)
+    {
+    }
+
+    bool pipelined() const
+    {
+      return pipelineOn;
+    }
+
+    void setPipelined(bool enable)
+    {
+      pipelineOn = enable;
+    }
+
+    void resetPipelined()
+    {
+      pipelineOn = false;
+    }
+
+    int pipelineDepth() const
+    {
+      return pipelineFrames;
+    }
+
+    void setPipelineDepth(int depth)
+    {
+      pipelineFrames = (depth < 1) ? 1 : depth;
+    }
+
+    void resetPipelineDepth()
+    {
+      pipelineFrames = 2;
+    }
+
+    // 0 means one worker thread per processor core
+    int workerCount() const
+    {
+      return workers;
+    }
+
+    void setWorkerCount(int count)
+    {
+      workers = (count < 0) ? 0 : count;
+    }
+
+    void resetWorkerCount()
+    {
+      workers = 0;
+    }
+
+    // execute linear chains of macros as one task
+    bool fuseChains() const
+    {
+      return fusionOn;
+    }
+
+    void setFuseChains(bool enable)
+    {
+      fusionOn = enable;
+    }
+
+    void resetFuseChains()
+    {
+      fusionOn = true;
+    }
+
+    // record a timeline of the next runs
+    bool tracing() const
+    {
+      return tracingOn;
+    }
+
+    void setTracing(bool enable)
+    {
+      tracingOn = enable;
+    }
+
+    TraceRecorder& trace()
+    {
+      return recorder;
+    }
+
+    bool criticalPathShown() const
+    {
+      return criticalPathOn;
+    }
+
+    void showCriticalPath(bool enable)
     {
+      criticalPathOn = enable;
     }
+
+    const CriticalPath& criticalPath() const
+    {
+      return longestPath;
+    }
+
+    void updateCriticalPath();
+
+    // mean time between two finished frames of the last run in micro seconds
+    qint64 observedFrameTime() const
+    {
+      return frameTime;
+    }
+
+    void setObservedFrameTime(qint64 musecs)
+    {
+      frameTime = musecs;
+    }
+
+    // writes runtime statistics of all macros of the last run; JSON for files ending with .json, CSV otherwise
+    bool saveRuntimeStatistics(const QString& fileName) const;
+    // writes the timeline of the last traced run in Chrome's trace event format
+    bool saveTrace(const QString& fileName) const;
+
+  private:
+    bool          pipelineOn;
+    int           pipelineFrames;
+    int           workers;
+    bool          fusionOn;
+    bool          tracingOn;
+    TraceRecorder recorder;
+    bool          criticalPathOn;
+    CriticalPath  longestPath;
+    qint64        frameTime;
   };
 
   class ProcessGraphCtrl;
+  class Macro;
+
+  class PGExecutionPlan
+  {
+  public:
+    // input reading slot (frame + frameOffset) of a multi-buffered output
+    struct DataLink
+    {
+      MacroInput*  input;
+      MacroOutput* output;
+      int          frameOffset;
+    };
+
+    struct Node
+    {
+      graph::Vertex* vertex;
+      Macro*         macro;
+      int            outputSlots;
+      int            succBegin;
+      int            succEnd;
+      int            predBegin;
+      int            predEnd;
+      int            linkBegin;
+      int            linkEnd;
+      int            chainNext;
+    };
+
+    PGExecutionPlan();
+
+    bool compile(const graph::GraphBase::ComponentMap& componentVertices, bool fuseChains = false);
+
+    int size() const
+    {
+      return nodes.size();
+    }
+
+    bool hasFeedback() const
+    {
+      return feedback;
+    }
+
+    int fusedLinks() const
+    {
+      return fused;
+    }
+
+    QVector<Node>     nodes;
+    QVector<int>      successors;
+    QVector<int>      predecessors;
+    QVector<DataLink> links;
+
+  private:
+    bool              feedback;
+    int               fused;
+  };
 
   class PGComponentHandler : public QObject
   {
     Q_OBJECT
   public:
-    PGComponentHandler(ProcessGraphCtrl* ctrl, graph::GraphBase::ComponentMap& componentVertices);
+    PGComponentHandler(ProcessGraphCtrl* ctrl, graph::GraphBase::ComponentMap& componentVertices, TaskExecutor& taskExecutor, int pipelineDepth = 1, bool fuseChains = false, TraceRecorder* traceRecorder = 0);
 
     unsigned long long id()
     {
-      return reinterpret_cast<unsigned long long>(&compWatcher);
+      return reinterpret_cast<unsigned long long>(this);
     }
 
     bool isRunnable();
+    bool hasFeedback() const
+    {
+      return plan.hasFeedback();
+    }
+
+    int frames() const;
+    qint64 frameTime() const;
+    qint64 schedulerOverhead() const;
+
     void runNext(bool snap, bool stop);
 
+  signals:
+    void frameFinished();
+    void macroStopped(int result);
+    void componentStopped(int result);
+
+  public slots:
+    void setPaused(bool pauseOn);
+    void cancel();
+
   private:
-    static int  applyFunctor(graph::Vertex::Ptr vertex);
-    static int  startFunctor(graph::Vertex::Ptr vertex);
+    typedef int (*MacroFunction)(Macro& macro, const graph::Vertex& vertex);
+
+    void scheduleAll();
+    int claimNode(int index);
+    bool tryDispatch(int index);
+    void runNode(int index, int frame);
+    int nodeFinished(int index, int result, int& nextFrame);
+    void stopNode(graph::Vertex::Ptr vertex);
+
+    static int  applyMacro(Macro& macro, const graph::Vertex& vertex);
+    static int  startMacro(Macro& macro, const graph::Vertex& vertex);
     static int  stopFunctor(graph::Vertex::Ptr vertex);
     static void collectResults(int& result, const int& intermediateResult);
 
     graph::GraphBase::ComponentMap vertices;
     ProcessGraphCtrl*              controller;
-    const int                      maxOrder;
-    int                            currentOrder;
-    bool                           init;
-    QFutureWatcher<int>            compWatcher;
+    TaskExecutor&                  executor;
+    TraceRecorder*                 trace;
+    PGExecutionPlan                plan;
+    QVector<int>                   framesDone;
+    QVector<bool>                  nodeRunning;
+    QVector<int>                   frameNodeCount;
+    QVector<qint64>                frameBegin;
+    int                            depth;
+    int                            maxFrames;
+    int                            frameLimit;
+    int                            framesStarted;
+    int                            framesFinished;
+    int                            tasksRunning;
+    int                            stopsPending;
+    int                            stopResult;
+    bool                           running;
+    bool                           paused;
+    bool                           canceled;
+    bool                           stopping;
+    bool                           notifyPending;
+    qint64                         overheadNsecs;
+    QElapsedTimer                  runClock;
+    qint64                         initDoneNsecs;
+    qint64                         lastFrameNsecs;
+    mutable QMutex                 mutex;
   };
 
   class ProcessGraphCtrl : public QObject
@@ -75,6 +326,17 @@ namespace app
 
     virtual bool event(QEvent* e);
 
+    // stop processing after the given number of frames including the initialization frame, 0 runs until stopped
+    void setMaxFrames(int frames)
+    {
+      frameCount = (frames < 0) ? 0 : frames;
+    }
+
+    int maxFrames() const
+    {
+      return frameCount;
+    }
+
   signals:
     void paused(bool pauseOn);
     void abortComputation();
@@ -86,7 +348,8 @@ namespace app
     void stop();
 
     void continueProcessing();
-    void terminateProcessing();
+    void terminateProcessing(int result);
+    void requestStop(int result);
 
   private slots:
     void initProcessing();
@@ -99,11 +362,14 @@ namespace app
 
     ProcessGraph&     processGraph;
     GraphComponentMap components;
+    TaskExecutor*     executor;
+    TraceRecorder*    trace;
     bool              flagError;
     bool              flagPause;
     bool              flagSnap;
     bool              flagStop;
     int               compCounter;
+    int               frameCount;
   };
 
 }
@@ -0,0 +1,221 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+
+#include "apptrace.h"
+#include <QFile>
+#include <QThread>
+#include <QTextStream>
+#include <QAtomicInteger>
+
+namespace app
+{
+  // buffers of the current thread for the last recording sessions it contributed to,
+  // several recorders may be active at the same time, e.g. for graphs running side by side
+  struct CachedBuffer
+  {
+    quint64 session;
+    void*   buffer;
+  };
+  static const int cacheSize = 4;
+  static thread_local CachedBuffer cachedBuffers[cacheSize] = {};
+  static thread_local int cacheNext = 0;
+  static QAtomicInteger<quint64> sessionCounter(0);
+
+  static QString jsonString(const QString& text)
+  {
+    QString result;
+    result.reserve(text.length() + 2);
+    result += '"';
+    foreach(QChar c, text)
+    {
+      if (c == '"' || c == '\\')
+      {
+        result += '\\';
+        result += c;
+      }
+      else if (c.unicode() < 0x20)
+      {
+        result += QString("\\u%1").arg(c.unicode(),4,16,QChar('0'));
+      }
+      else
+      {
+        result += c;
+      }
+    }
+    result += '"';
+    return result;
+  }
+
+  TraceRecorder::TraceRecorder() : buffers(), mutex(), clock(), session(0)
+  {
+  }
+
+  TraceRecorder::~TraceRecorder()
+  {
+    qDeleteAll(buffers);
+  }
+
+  void TraceRecorder::start()
+  {
+    QMutexLocker lock(&mutex);
+    qDeleteAll(buffers);
+    buffers.clear();
+    // a new session invalidates the buffers cached by all threads
+    session.storeRelease(sessionCounter.fetchAndAddRelaxed(1) + 1);
+    clock.start();
+  }
+
+  void TraceRecorder::stop()
+  {
+    QMutexLocker lock(&mutex);
+    session.storeRelease(0);
+  }
+
+  bool TraceRecorder::isEmpty() const
+  {
+    QMutexLocker lock(&mutex);
+    return buffers.isEmpty();
+  }
+
+  void TraceRecorder::nameThread(const QString& name)
+  {
+    quint64 current = session.loadAcquire();
+    if (current == 0) return;
+    buffer(current).name = name;
+  }
+
+  void TraceRecorder::complete(const QString& name, const char* category, qint64 begin, int frame)
+  {
+    append(name,category,'X',begin,now(),frame);
+  }
+
+  void TraceRecorder::instant(const QString& name, const char* category, int frame)
+  {
+    qint64 time = now();
+    append(name,category,'i',time,time,frame);
+  }
+
+  void TraceRecorder::span(const QString& name, const char* category, qint64 begin, int frame)
+  {
+    // spans may overlap on one thread, e.g. frames of a pipelined graph
+    append(name,category,'A',begin,now(),frame);
+  }
+
+  TraceRecorder::ThreadBuffer& TraceRecorder::buffer(quint64 current)
+  {
+    for(int i = 0; i < cacheSize; ++i)
+    {
+      if (cachedBuffers[i].session == current && cachedBuffers[i].buffer != 0)
+      {
+        return *static_cast<ThreadBuffer*>(cachedBuffers[i].buffer);
+      }
+    }
+    // cache miss: the thread may already own a buffer of this session
+    QMutexLocker lock(&mutex);
+    Qt::HANDLE thread = QThread::currentThreadId();
+    ThreadBuffer* threadBuffer = 0;
+    foreach(ThreadBuffer* existing, buffers)
+    {
+      if (existing->thread == thread)
+      {
+        threadBuffer = existing;
+        break;
+      }
+    }
+    if (threadBuffer == 0)
+    {
+      threadBuffer = new ThreadBuffer();
+      threadBuffer->id = buffers.size() + 1;
+      threadBuffer->thread = thread;
+      threadBuffer->name = QThread::currentThread()->objectName();
+      if (threadBuffer->name.isEmpty())
+      {
+        threadBuffer->name = QString("Thread %1").arg(threadBuffer->id);
+      }
+      threadBuffer->events.reserve(4096);
+      buffers.append(threadBuffer);
+    }
+    cachedBuffers[cacheNext].session = current;
+    cachedBuffers[cacheNext].buffer = threadBuffer;
+    cacheNext = (cacheNext + 1) % cacheSize;
+    return *threadBuffer;
+  }
+
+  void TraceRecorder::append(const QString& name, const char* category, char phase, qint64 begin, qint64 end, int frame)
+  {
+    quint64 current = session.loadAcquire();
+    if (current == 0) return;
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.begin = begin;
+    event.end = end;
+    event.frame = frame;
+    event.phase = phase;
+    buffer(current).events.append(event);
+  }
+
+  bool TraceRecorder::save(const QString& fileName) const
+  {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+      return false;
+    }
+    QMutexLocker lock(&mutex);
+    QTextStream stream(&file);
+    stream.setRealNumberNotation(QTextStream::FixedNotation);
+    stream.setRealNumberPrecision(3);
+    // time stamps of the trace event format are given in micro seconds
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    stream << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Impresario\"}}";
+    int asyncId = 0;
+    foreach(const ThreadBuffer* threadBuffer, buffers)
+    {
+      stream << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << threadBuffer->id << ",\"args\":{\"name\":" << jsonString(threadBuffer->name) << "}}";
+      foreach(const Event& event, threadBuffer->events)
+      {
+        QString common = QString("\"name\":%1,\"cat\":\"%2\",\"pid\":1,\"tid\":%3").arg(jsonString(event.name)).arg(event.category).arg(threadBuffer->id);
+        QString args = (event.frame >= 0) ? QString(",\"args\":{\"frame\":%1}").arg(event.frame) : QString();
+        switch(event.phase)
+        {
+          case 'X':
+            stream << ",\n{\"ph\":\"X\"," << common << ",\"ts\":" << event.begin / 1000.0 << ",\"dur\":" << (event.end - event.begin) / 1000.0 << args << '}';
+            break;
+          case 'i':
+            stream << ",\n{\"ph\":\"i\",\"s\":\"t\"," << common << ",\"ts\":" << event.begin / 1000.0 << args << '}';
+            break;
+          case 'A':
+            ++asyncId;
+            stream << ",\n{\"ph\":\"b\",\"id\":" << asyncId << ',' << common << ",\"ts\":" << event.begin / 1000.0 << args << '}';
+            stream << ",\n{\"ph\":\"e\",\"id\":" << asyncId << ',' << common << ",\"ts\":" << event.end / 1000.0 << '}';
+            break;
+          default:
+            break;
+        }
+      }
+    }
+    stream << "\n]}\n";
+    stream.flush();
+    return file.error() == QFileDevice::NoError;
+  }
+
+}
@@ -0,0 +1,92 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+#ifndef APPTRACE_H
+#define APPTRACE_H
+
+#include <QString>
+#include <QVector>
+#include <QList>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QAtomicInteger>
+
+namespace app
+{
+  // Records a timeline of a process graph run. Each thread appends events to its own buffer without
+  // locking, only the first event of a thread registers its buffer. The timeline is saved in Chrome's
+  // trace event format which can be opened in chrome://tracing or ui.perfetto.dev.
+  class TraceRecorder
+  {
+  public:
+    TraceRecorder();
+    ~TraceRecorder();
+
+    void start();
+    void stop();
+
+    bool isEmpty() const;
+
+    // time since start() in nano seconds
+    qint64 now() const
+    {
+      return clock.nsecsElapsed();
+    }
+
+    void nameThread(const QString& name);
+    void complete(const QString& name, const char* category, qint64 begin, int frame = -1);
+    void instant(const QString& name, const char* category, int frame = -1);
+    void span(const QString& name, const char* category, qint64 begin, int frame);
+
+    bool save(const QString& fileName) const;
+
+  private:
+    Q_DISABLE_COPY(TraceRecorder)
+
+    struct Event
+    {
+      QString     name;
+      const char* category;
+      qint64      begin;
+      qint64      end;
+      int         frame;
+      char        phase;
+    };
+
+    struct ThreadBuffer
+    {
+      int            id;
+      Qt::HANDLE     thread;
+      QString        name;
+      QVector<Event> events;
+    };
+
+    ThreadBuffer& buffer(quint64 current);
+    void append(const QString& name, const char* category, char phase, qint64 begin, qint64 end, int frame);
+
+    QList<ThreadBuffer*>    buffers;
+    mutable QMutex          mutex;
+    QElapsedTimer           clock;
+    // read by all recording threads, 0 while not recording
+    QAtomicInteger<quint64> session;
+  };
+
+}
+#endif // APPTRACE_H
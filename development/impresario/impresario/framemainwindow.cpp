@@ -212,10 +212,14 @@ namespace frame
     multiplexer.connect(Resource::action(Resource::CTRL_PAUSE), SIGNAL(triggered()), SLOT(ctrlPause()));
     multiplexer.connect(Resource::action(Resource::CTRL_STOP), SIGNAL(triggered()), SLOT(ctrlStop()));
     multiplexer.connect(Resource::action(Resource::CTRL_SNAP), SIGNAL(triggered()), SLOT(ctrlSnap()));
+    multiplexer.connect(Resource::action(Resource::CTRL_EXPORTSTATS), SIGNAL(triggered()), SLOT(ctrlExportStatistics()));
+    multiplexer.connect(Resource::action(Resource::CTRL_EXPORTTRACE), SIGNAL(triggered()), SLOT(ctrlExportTrace()));
     multiplexer.connect(SIGNAL(updateStartCommand(bool)),Resource::action(Resource::CTRL_START), SLOT(setEnabled(bool)));
     multiplexer.connect(SIGNAL(updatePauseCommand(bool)),Resource::action(Resource::CTRL_PAUSE), SLOT(setEnabled(bool)));
     multiplexer.connect(SIGNAL(updateStopCommand(bool)),Resource::action(Resource::CTRL_STOP), SLOT(setEnabled(bool)));
     multiplexer.connect(SIGNAL(updateSnapCommand(bool)),Resource::action(Resource::CTRL_SNAP), SLOT(setEnabled(bool)));
+    multiplexer.connect(SIGNAL(updateSnapCommand(bool)),Resource::action(Resource::CTRL_EXPORTSTATS), SLOT(setEnabled(bool)));
+    multiplexer.connect(SIGNAL(updateSnapCommand(bool)),Resource::action(Resource::CTRL_EXPORTTRACE), SLOT(setEnabled(bool)));
     multiplexer.connect(SIGNAL(updateCheckStartCommand(bool)),Resource::action(Resource::CTRL_START), SLOT(setChecked(bool)));
     multiplexer.connect(SIGNAL(updateCheckPauseCommand(bool)),Resource::action(Resource::CTRL_PAUSE), SLOT(setChecked(bool)));
     multiplexer.connect(SIGNAL(updateCheckStopCommand(bool)),Resource::action(Resource::CTRL_STOP), SLOT(setChecked(bool)));
@@ -250,7 +254,7 @@ namespace frame
     QString fileName = QFileDialog::getOpenFileName(this,
                                                     tr("Open ProcessGraph"),
                                                     pgPath,
-                                                    tr("Impresario Process Graphs (*.ipg);; All files (*.*)"));
+                                                    tr("Impresario Process Graphs (*.ipg *.ipgb);; All files (*.*)"));
     if (!fileName.isEmpty())
     {
       QMdiSubWindow* existing = mdiChildFind(fileName);
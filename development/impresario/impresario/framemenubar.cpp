@@ -80,6 +80,9 @@ namespace frame
     menuControl->addAction(Resource::action(Resource::CTRL_STOP));
     menuControl->addSeparator();
     menuControl->addAction(Resource::action(Resource::CTRL_SNAP));
+    menuControl->addSeparator();
+    menuControl->addAction(Resource::action(Resource::CTRL_EXPORTSTATS));
+    menuControl->addAction(Resource::action(Resource::CTRL_EXPORTTRACE));
 
     // build extras menu
     menuExtras = this->addMenu(tr("E&xtras"));
@@ -0,0 +1,340 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+
+#include "graphbinary.h"
+#include <QtEndian>
+#include <QObject>
+#include <cstring>
+
+namespace graph
+{
+  static const char binaryMagic[4] = { 'I', 'P', 'G', 'B' };
+  static const int  binaryHeaderSize = 12;
+  static const int  binarySectionEntrySize = 24;
+
+  //-----------------------------------------------------------------------
+  // Class BinaryFormat
+  //-----------------------------------------------------------------------
+  bool BinaryFormat::isBinary(QIODevice& device)
+  {
+    QByteArray magic = device.peek(sizeof(binaryMagic));
+    return magic.size() == sizeof(binaryMagic) && std::memcmp(magic.constData(),binaryMagic,sizeof(binaryMagic)) == 0;
+  }
+
+  //-----------------------------------------------------------------------
+  // Class BinaryWriter
+  //-----------------------------------------------------------------------
+  BinaryWriter::BinaryWriter() : stringIndex(), strings(), sections(), data(0), records()
+  {
+  }
+
+  void BinaryWriter::setSection(BinaryFormat::Section section)
+  {
+    Q_ASSERT_X(records.isEmpty(),"graph::BinaryWriter::setSection","Section changed within a record.");
+    data = &sections[section];
+  }
+
+  void BinaryWriter::append(const void* value, int size)
+  {
+    Q_ASSERT_X(data != 0,"graph::BinaryWriter::append","No section set.");
+    data->append(static_cast<const char*>(value),size);
+  }
+
+  void BinaryWriter::writeUInt8(quint8 value)
+  {
+    append(&value,1);
+  }
+
+  void BinaryWriter::writeUInt32(quint32 value)
+  {
+    quint32 le = qToLittleEndian(value);
+    append(&le,4);
+  }
+
+  void BinaryWriter::writeDouble(double value)
+  {
+    quint64 bits;
+    std::memcpy(&bits,&value,8);
+    bits = qToLittleEndian(bits);
+    append(&bits,8);
+  }
+
+  void BinaryWriter::writeUuid(const QUuid& value)
+  {
+    QByteArray bytes = value.toRfc4122();
+    append(bytes.constData(),bytes.size());
+  }
+
+  void BinaryWriter::writeString(const QString& value)
+  {
+    QHash<QString,quint32>::const_iterator it = stringIndex.constFind(value);
+    if (it == stringIndex.constEnd())
+    {
+      it = stringIndex.insert(value,strings.size());
+      strings.append(value);
+    }
+    writeUInt32(it.value());
+  }
+
+  void BinaryWriter::beginRecord()
+  {
+    // size of record is filled in when the record ends
+    records.append(data->size());
+    writeUInt32(0);
+  }
+
+  void BinaryWriter::endRecord()
+  {
+    Q_ASSERT_X(!records.isEmpty(),"graph::BinaryWriter::endRecord","No record started.");
+    int start = records.takeLast();
+    quint32 size = qToLittleEndian(static_cast<quint32>(data->size() - start - 4));
+    std::memcpy(data->data() + start,&size,4);
+  }
+
+  bool BinaryWriter::write(QIODevice& device) const
+  {
+    // string table is the first section
+    QByteArray stringData;
+    quint32 value = qToLittleEndian(static_cast<quint32>(strings.size()));
+    stringData.append(reinterpret_cast<const char*>(&value),4);
+    foreach(const QString& str, strings)
+    {
+      value = qToLittleEndian(static_cast<quint32>(str.size()));
+      stringData.append(reinterpret_cast<const char*>(&value),4);
+      for(int i = 0; i < str.size(); ++i)
+      {
+        quint16 unit = qToLittleEndian(str.at(i).unicode());
+        stringData.append(reinterpret_cast<const char*>(&unit),2);
+      }
+    }
+    QMap<quint32,QByteArray> allSections = sections;
+    allSections.insert(BinaryFormat::Strings,stringData);
+    // header and section table, sections start at offsets aligned to 8 bytes
+    QByteArray header(binaryMagic,sizeof(binaryMagic));
+    quint16 version = qToLittleEndian(BinaryFormat::versionMajor);
+    header.append(reinterpret_cast<const char*>(&version),2);
+    version = qToLittleEndian(BinaryFormat::versionMinor);
+    header.append(reinterpret_cast<const char*>(&version),2);
+    value = qToLittleEndian(static_cast<quint32>(allSections.size()));
+    header.append(reinterpret_cast<const char*>(&value),4);
+    quint64 offset = binaryHeaderSize + allSections.size() * binarySectionEntrySize;
+    for(QMap<quint32,QByteArray>::const_iterator it = allSections.constBegin(); it != allSections.constEnd(); ++it)
+    {
+      offset = (offset + 7) & ~Q_UINT64_C(7);
+      quint32 type = qToLittleEndian(it.key());
+      quint32 reserved = 0;
+      quint64 sectionOffset = qToLittleEndian(offset);
+      quint64 sectionSize = qToLittleEndian(static_cast<quint64>(it.value().size()));
+      header.append(reinterpret_cast<const char*>(&type),4);
+      header.append(reinterpret_cast<const char*>(&reserved),4);
+      header.append(reinterpret_cast<const char*>(&sectionOffset),8);
+      header.append(reinterpret_cast<const char*>(&sectionSize),8);
+      offset += it.value().size();
+    }
+    if (device.write(header) != header.size()) return false;
+    qint64 written = header.size();
+    for(QMap<quint32,QByteArray>::const_iterator it = allSections.constBegin(); it != allSections.constEnd(); ++it)
+    {
+      QByteArray padding(static_cast<int>(((written + 7) & ~7) - written),'\0');
+      if (device.write(padding) != padding.size() || device.write(it.value()) != it.value().size()) return false;
+      written += padding.size() + it.value().size();
+    }
+    return true;
+  }
+
+  //-----------------------------------------------------------------------
+  // Class BinaryReader
+  //-----------------------------------------------------------------------
+  BinaryReader::BinaryReader(QFile& file) : dataFileName(file.fileName()), buffer(), base(0), length(file.size()), sectionTable(), strings(),
+    pos(0), end(0), records(), error()
+  {
+    base = file.map(0,length);
+    if (base == 0)
+    {
+      buffer = file.readAll();
+      base = reinterpret_cast<const uchar*>(buffer.constData());
+      length = buffer.size();
+    }
+    readHeader();
+  }
+
+  bool BinaryReader::readHeader()
+  {
+    end = length;
+    const uchar* header = read(binaryHeaderSize);
+    if (header == 0 || std::memcmp(header,binaryMagic,sizeof(binaryMagic)) != 0)
+    {
+      raiseError(QObject::tr("File is not a binary process graph."));
+      return false;
+    }
+    quint16 major = qFromLittleEndian<quint16>(header + 4);
+    quint16 minor = qFromLittleEndian<quint16>(header + 6);
+    if (major != BinaryFormat::versionMajor)
+    {
+      raiseError(QString(QObject::tr("Binary format version %1.%2 is not supported.")).arg(major).arg(minor));
+      return false;
+    }
+    quint32 count = qFromLittleEndian<quint32>(header + 8);
+    for(quint32 i = 0; i < count; ++i)
+    {
+      const uchar* entry = read(binarySectionEntrySize);
+      if (entry == 0) return false;
+      qint64 offset = static_cast<qint64>(qFromLittleEndian<quint64>(entry + 8));
+      qint64 size = static_cast<qint64>(qFromLittleEndian<quint64>(entry + 16));
+      if (offset < 0 || size < 0 || offset > length || size > length - offset)
+      {
+        raiseError(QString(QObject::tr("Section %1 exceeds the end of the file.")).arg(i));
+        return false;
+      }
+      sectionTable.insert(qFromLittleEndian<quint32>(entry),qMakePair(offset,size));
+    }
+    // strings are decoded once, all other data is read on demand
+    if (!setSection(BinaryFormat::Strings)) return false;
+    quint32 stringCount = readUInt32();
+    strings.reserve(static_cast<int>(qMin<qint64>(stringCount,length / 4)));
+    for(quint32 i = 0; i < stringCount && !hasError(); ++i)
+    {
+      quint32 size = readUInt32();
+      const uchar* units = read(static_cast<qint64>(size) * 2);
+      if (units == 0) return false;
+      QString str(static_cast<int>(size),Qt::Uninitialized);
+      for(quint32 k = 0; k < size; ++k)
+      {
+        str[k] = QChar(qFromLittleEndian<quint16>(units + 2 * k));
+      }
+      strings.append(str);
+    }
+    return !hasError();
+  }
+
+  bool BinaryReader::setSection(BinaryFormat::Section section)
+  {
+    if (hasError()) return false;
+    if (!sectionTable.contains(section))
+    {
+      raiseError(QString(QObject::tr("Section %1 is missing.")).arg(section));
+      return false;
+    }
+    records.clear();
+    pos = sectionTable[section].first;
+    end = pos + sectionTable[section].second;
+    return true;
+  }
+
+  const uchar* BinaryReader::read(qint64 size)
+  {
+    if (hasError()) return 0;
+    qint64 limit = records.isEmpty() ? end : records.last();
+    if (size > limit - pos)
+    {
+      raiseError(QString(QObject::tr("At offset %1: Unexpected end of data.")).arg(pos));
+      return 0;
+    }
+    const uchar* ptr = base + pos;
+    pos += size;
+    return ptr;
+  }
+
+  quint8 BinaryReader::readUInt8()
+  {
+    const uchar* ptr = read(1);
+    return (ptr != 0) ? *ptr : 0;
+  }
+
+  quint32 BinaryReader::readUInt32()
+  {
+    const uchar* ptr = read(4);
+    return (ptr != 0) ? qFromLittleEndian<quint32>(ptr) : 0;
+  }
+
+  double BinaryReader::readDouble()
+  {
+    const uchar* ptr = read(8);
+    if (ptr == 0) return 0.0;
+    quint64 bits = qFromLittleEndian<quint64>(ptr);
+    double value;
+    std::memcpy(&value,&bits,8);
+    return value;
+  }
+
+  QUuid BinaryReader::readUuid()
+  {
+    const uchar* ptr = read(16);
+    return (ptr != 0) ? QUuid::fromRfc4122(QByteArray::fromRawData(reinterpret_cast<const char*>(ptr),16)) : QUuid();
+  }
+
+  QString BinaryReader::readString()
+  {
+    quint32 index = readUInt32();
+    if (hasError()) return QString();
+    if (index >= static_cast<quint32>(strings.size()))
+    {
+      raiseError(QString(QObject::tr("At offset %1: Invalid string reference %2.")).arg(pos).arg(index));
+      return QString();
+    }
+    return strings[index];
+  }
+
+  QString BinaryReader::peekString()
+  {
+    qint64 start = pos;
+    QString str = readString();
+    pos = start;
+    return str;
+  }
+
+  bool BinaryReader::beginRecord()
+  {
+    quint32 size = readUInt32();
+    qint64 limit = records.isEmpty() ? end : records.last();
+    if (hasError() || size > limit - pos)
+    {
+      raiseError(QString(QObject::tr("At offset %1: Element exceeds the end of its enclosing element.")).arg(pos));
+      return false;
+    }
+    records.append(pos + size);
+    return true;
+  }
+
+  void BinaryReader::endRecord()
+  {
+    // data of the record which was not read is skipped
+    if (records.isEmpty()) return;
+    pos = records.takeLast();
+  }
+
+  void BinaryReader::skipRecord()
+  {
+    if (beginRecord())
+    {
+      endRecord();
+    }
+  }
+
+  void BinaryReader::raiseError(const QString& message)
+  {
+    if (error.isEmpty())
+    {
+      error = message;
+    }
+  }
+
+}
@@ -0,0 +1,171 @@
+/******************************************************************************************
+**   Impresario - Image Processing Engineering System applying Reusable Interactive Objects
+**   Copyright (C) 2015-2020  Lars Libuda
+**
+**   This file is part of Impresario.
+**
+**   Impresario is free software: you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation, either version 3 of the License, or
+**   (at your option) any later version.
+**
+**   Impresario is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**   GNU General Public License for more details.
+**
+**   You should have received a copy of the GNU General Public License
+**   along with Impresario in subdirectory "licenses", file "LICENSE_Impresario.GPLv3".
+**   If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************************/
+#ifndef GRAPHBINARY_H
+#define GRAPHBINARY_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QUuid>
+#include <QFile>
+#include <QIODevice>
+#include <QPair>
+
+namespace graph
+{
+  // Binary graph files store the same content as the XML format in a compact form which can be
+  // mapped into memory. All numbers are little endian.
+  //   header:   "IPGB", quint16 major version, quint16 minor version, quint32 section count
+  //   table:    per section quint32 type, quint32 reserved, quint64 offset, quint64 size
+  //   sections: string table (quint32 count, per string quint32 length and UTF-16 code units)
+  //             followed by the graph, vertex and edge sections
+  // Strings are written as index into the string table. Each element is a record prefixed with
+  // its size, so readers can skip elements (e.g. visualization) without decoding them.
+  class BinaryFormat
+  {
+  public:
+    enum Section
+    {
+      Strings = 1,
+      Graph,
+      Vertices,
+      Edges
+    };
+
+    enum PropertyType
+    {
+      PropertyNull,
+      PropertyText,
+      PropertyEnum,
+      PropertyData,
+      PropertyItem,
+      PropertyScene
+    };
+
+    static const quint16 versionMajor = 1;
+    static const quint16 versionMinor = 0;
+
+    static bool isBinary(QIODevice& device);
+  };
+
+  class BinaryWriter
+  {
+  public:
+    BinaryWriter();
+
+    void setSection(BinaryFormat::Section section);
+
+    void writeUInt8(quint8 value);
+    void writeUInt32(quint32 value);
+    void writeDouble(double value);
+    void writeUuid(const QUuid& value);
+    void writeString(const QString& value);
+
+    void beginRecord();
+    void endRecord();
+
+    bool write(QIODevice& device) const;
+
+  private:
+    Q_DISABLE_COPY(BinaryWriter)
+
+    void append(const void* value, int size);
+
+    QHash<QString,quint32>      stringIndex;
+    QVector<QString>            strings;
+    QMap<quint32,QByteArray>    sections;
+    QByteArray*                 data;
+    QVector<int>                records;
+  };
+
+  class BinaryReader
+  {
+  public:
+    // maps file into memory if possible, otherwise the file is read completely
+    BinaryReader(QFile& file);
+
+    const QString& fileName() const
+    {
+      return dataFileName;
+    }
+
+    bool hasSection(BinaryFormat::Section section) const
+    {
+      return sectionTable.contains(section);
+    }
+
+    bool setSection(BinaryFormat::Section section);
+
+    quint8 readUInt8();
+    quint32 readUInt32();
+    double readDouble();
+    QUuid readUuid();
+    QString readString();
+    // returns the next string without advancing
+    QString peekString();
+
+    bool beginRecord();
+    void endRecord();
+    void skipRecord();
+
+    qint64 offset() const
+    {
+      return pos;
+    }
+
+    bool atRecordEnd() const
+    {
+      return pos >= (records.isEmpty() ? end : records.last());
+    }
+
+    bool hasError() const
+    {
+      return !error.isEmpty();
+    }
+
+    const QString& errorString() const
+    {
+      return error;
+    }
+
+    void raiseError(const QString& message);
+
+  private:
+    Q_DISABLE_COPY(BinaryReader)
+
+    bool readHeader();
+    const uchar* read(qint64 size);
+
+    QString                               dataFileName;
+    QByteArray                            buffer;
+    const uchar*                          base;
+    qint64                                length;
+    QMap<quint32,QPair<qint64,qint64> >   sectionTable;
+    QVector<QString>                      strings;
+    qint64                                pos;
+    qint64                                end;
+    QVector<qint64>                       records;
+    QString                               error;
+  };
+}
+#endif // GRAPHBINARY_H
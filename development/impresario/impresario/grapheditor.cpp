@@ -362,6 +362,7 @@ namespace graph
     {
       return;
     }
+    graphBase.beginUpdate();
     if (!reverseOrder)
     {
       for(BaseItemList::const_iterator it = elementItems.begin(); it != elementItems.end(); ++it)
@@ -409,6 +410,7 @@ namespace graph
         }
       }
     }
+    graphBase.endUpdate();
   }
 
   void SceneEditor::removeElementItemsFromGraph(const BaseItemList& elementItems, bool reverseOrder)
@@ -417,6 +419,7 @@ namespace graph
     {
       return;
     }
+    graphBase.beginUpdate();
     if (!reverseOrder)
     {
       for(BaseItemList::const_iterator it = elementItems.begin(); it != elementItems.end(); ++it)
@@ -464,6 +467,7 @@ namespace graph
         }
       }
     }
+    graphBase.endUpdate();
   }
 
   void SceneEditor::copyElementItemsToClipboard(const BaseItemList& elementItems) const
@@ -617,6 +621,27 @@ namespace graph
 
     // load graph
     if (!graphBase.load(stream,elementManager)) return false;
+    registerGraphElements();
+    return true;
+  }
+
+  void SceneEditor::save(BinaryWriter &stream) const
+  {
+    graphBase.save(stream);
+  }
+
+  bool SceneEditor::load(BinaryReader &stream)
+  {
+    connect(&graphBase,SIGNAL(statusUpdated(int)),this,SLOT(onGraphModified(int)));
+
+    // load graph
+    if (!graphBase.load(stream,elementManager)) return false;
+    registerGraphElements();
+    return true;
+  }
+
+  void SceneEditor::registerGraphElements()
+  {
     // update references
     foreach(Vertex::Ptr vertex,graphBase.vertexList())
     {
@@ -627,7 +652,6 @@ namespace graph
     {
       graphElements.insert(edge->id(),edge.toWeakRef());
     }
-    return true;
   }
 
   void SceneEditor::onGraphModified(int reason)
@@ -208,6 +208,8 @@ namespace graph
   protected:
     virtual void save(QXmlStreamWriter &stream) const;
     virtual bool load(QXmlStreamReader &stream);
+    virtual void save(BinaryWriter &stream) const;
+    virtual bool load(BinaryReader &stream);
 
     BaseItemList createVertexItem(int countInstances, const QStringList& signatures, QPointF startPos = QPointF(0.0,0.0));
     BaseItemList createEdgeItem(Pin::Ptr srcPin,Pin::Ptr destPin,const QString& edgeSignature);
@@ -215,6 +217,7 @@ namespace graph
     BaseItemList collectElementItemsForClipboard();
     BaseItemList pasteElementItemsFromClipboard();
     void clearElements();
+    void registerGraphElements();
 
     virtual void initialize();
     virtual void onVertexTypeLeftClickDrop(const QString& typeSignature, QPointF pos);
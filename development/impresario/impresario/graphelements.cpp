@@ -297,6 +297,19 @@ namespace graph
     }
   }
 
+  int Vertex::linearChain() const
+  {
+    DirectedGraph* graph = dynamic_cast<DirectedGraph*>(this->graph().data());
+    if (graph != 0)
+    {
+      return graph->vertexChain(id());
+    }
+    else
+    {
+      return -1;
+    }
+  }
+
   bool Vertex::isInCycle() const
   {
     DirectedGraph* graph = dynamic_cast<DirectedGraph*>(this->graph().data());
@@ -330,7 +343,7 @@ namespace graph
     if (!readElementStart(stream)) return false;
     if (!readProperties(stream)) return false;
 
-    if (stream.readNextStartElement() && stream.name() == "pins")
+    if (readNextStartElement(stream) && stream.name() == "pins")
     {
       for(PinMap::const_iterator it = vertexPins.begin(); it != vertexPins.end(); ++it)
       {
@@ -355,6 +368,40 @@ namespace graph
     return true;
   }
 
+  void Vertex::save(BinaryWriter& stream) const
+  {
+    writeElementStart(stream); // vertex
+    writeProperties(stream);
+
+    stream.writeUInt32(vertexPins.count());
+    for(PinMap::const_iterator it = vertexPins.begin(); it != vertexPins.end(); ++it)
+    {
+      it.value()->save(stream);
+    }
+
+    writeElementEnd(stream); // vertex
+  }
+
+  bool Vertex::load(BinaryReader& stream)
+  {
+    if (!readElementStart(stream)) return false;
+    if (!readProperties(stream)) return false;
+
+    quint32 count = stream.readUInt32();
+    if (count < static_cast<quint32>(vertexPins.count()))
+    {
+      stream.raiseError(QString(QObject::tr("At offset %1: Failed to read pin element of class instance '%2' (element '%3').")).arg(stream.offset()).arg(QString(metaObject()->className())).arg(element()));
+      return false;
+    }
+    for(PinMap::const_iterator it = vertexPins.begin(); it != vertexPins.end(); ++it)
+    {
+      if (!it.value()->load(stream)) return false;
+    }
+    // additional pins stored in file are skipped together with the vertex record
+    if (!readElementEnd(stream)) return false;
+    return true;
+  }
+
   void Vertex::pinDataAdded(PinData::Ptr pinType)
   {
     if (!pinType.isNull())
@@ -342,8 +342,12 @@ namespace graph
 
     bool isInCycle() const;
 
+    int linearChain() const;
+
     virtual void save(QXmlStreamWriter& stream) const;
     virtual bool load(QXmlStreamReader& stream);
+    virtual void save(BinaryWriter& stream) const;
+    virtual bool load(BinaryReader& stream);
 
     enum StatusChange
     {
@@ -625,17 +625,7 @@ namespace graph
       QRegExp regExp("\\{(\\d+(\\.\\d+)?);(\\d+(\\.\\d+)?)\\}");
       if (regExp.exactMatch(content))
       {
-        QSizeF size(regExp.cap(1).toDouble(),regExp.cap(3).toDouble());
-        QSizeF min = calcItemMinSize(minSize,layoutDir);
-        if (size.width() < min.width())
-        {
-          size.setWidth(min.width());
-        }
-        if (size.height() < min.height())
-        {
-          size.setHeight(min.height());
-        }
-        setItemRect(QRectF(QPointF(-size.width()/2.0,-size.height()/2.0),size));
+        setLoadedSize(QSizeF(regExp.cap(1).toDouble(),regExp.cap(3).toDouble()));
       }
       else
       {
@@ -653,6 +643,45 @@ namespace graph
     return true;
   }
 
+  void VertexItem::save(BinaryWriter& stream) const
+  {
+    writeElementStart(stream);
+    stream.writeDouble(pos().x());
+    stream.writeDouble(pos().y());
+    stream.writeDouble(rect.width());
+    stream.writeDouble(rect.height());
+    writeElementEnd(stream);
+  }
+
+  bool VertexItem::load(BinaryReader& stream)
+  {
+    if (!readElementStart(stream)) return false;
+    qreal x = stream.readDouble();
+    qreal y = stream.readDouble();
+    qreal width = stream.readDouble();
+    qreal height = stream.readDouble();
+    if (stream.hasError()) return false;
+    setPos(QPointF(x,y));
+    setLoadedSize(QSizeF(width,height));
+    if (!readElementEnd(stream)) return false;
+    return true;
+  }
+
+  void VertexItem::setLoadedSize(QSizeF size)
+  {
+    // sizes stored in files must not be smaller than the space needed for the pins
+    QSizeF min = calcItemMinSize(minSize,layoutDir);
+    if (size.width() < min.width())
+    {
+      size.setWidth(min.width());
+    }
+    if (size.height() < min.height())
+    {
+      size.setHeight(min.height());
+    }
+    setItemRect(QRectF(QPointF(-size.width()/2.0,-size.height()/2.0),size));
+  }
+
   void VertexItem::notifyBlock(bool blockOn)
   {
     setFlag(ItemIsMovable,!blockOn);
@@ -191,6 +191,11 @@ namespace graph
   protected:
     virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 
+    const QPainterPath& path() const
+    {
+      return linkPath;
+    }
+
   private:
     static void routerCallback(void *ptr);
     void setupLinkPath();
@@ -282,6 +287,8 @@ namespace graph
 
     virtual void save(QXmlStreamWriter& stream) const;
     virtual bool load(QXmlStreamReader &stream);
+    virtual void save(BinaryWriter& stream) const;
+    virtual bool load(BinaryReader& stream);
 
   protected:
     virtual void notifyBlock(bool blockOn);
@@ -303,6 +310,7 @@ namespace graph
 
   private:
     void updateEdgeItems();
+    void setLoadedSize(QSizeF size);
 
     QRectF                       rect;
     QRectF                       rcInterior;
@@ -25,13 +25,16 @@
 #include <QMetaObject>
 #include <QMetaProperty>
 #include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QVector>
 
 namespace graph
 {
   //-----------------------------------------------------------------------
   // Class ElementManager
   //-----------------------------------------------------------------------
-  ElementManager::ElementManager() : QObject(0), mutex(QMutex::Recursive), vertexTypes(), edgeTypes(), vertexInstances(), edgeInstances()
+  ElementManager::ElementManager() : QObject(0), mutex(QMutex::Recursive), vertexTypes(), edgeTypes(), vertexInstances(), edgeInstances(), vertexIndex(), edgeIndex(), vertexIds(), edgeIds()
   {
   }
 
@@ -43,6 +46,10 @@ namespace graph
   void ElementManager::clear()
   {
     QMutexLocker lock(&mutex);
+    vertexIds.clear();
+    edgeIds.clear();
+    vertexIndex.clear();
+    edgeIndex.clear();
     vertexInstances.clear();
     edgeInstances.clear();
     vertexTypes.clear();
@@ -96,7 +103,11 @@ namespace graph
     }
     VertexData::Ptr vertexDataType = vertexTypes[signature];
     Vertex::Ptr vertexInstance = Vertex::Ptr(new Vertex(vertexDataType->clone()));
-    vertexInstances.insert(vertexDataType->signature(),vertexInstance);
+    IndexEntry<VertexInstanceMap::iterator> entry;
+    entry.instance = vertexInstances.insert(vertexDataType->signature(),vertexInstance);
+    entry.id = vertexInstance->id();
+    vertexIndex.insert(vertexInstance.data(),entry);
+    vertexIds.insert(entry.id,vertexInstance.data());
     connect(vertexInstance.data(),SIGNAL(statusUpdated(graph::BaseElement&,int)),this,SLOT(vertexDataRefChanged(graph::BaseElement&,int)));
     emit vertexCreated(vertexInstance);
     return vertexInstance;
@@ -138,7 +149,11 @@ namespace graph
     }
     EdgeData::Ptr edgeDataType = edgeTypes[signature];
     Edge::Ptr edgeInstance = Edge::Ptr(new Edge(source, destination, edgeDataType->clone()));
-    edgeInstances.insert(edgeDataType->signature(),edgeInstance);
+    IndexEntry<EdgeInstanceMap::iterator> entry;
+    entry.instance = edgeInstances.insert(edgeDataType->signature(),edgeInstance);
+    entry.id = edgeInstance->id();
+    edgeIndex.insert(edgeInstance.data(),entry);
+    edgeIds.insert(entry.id,edgeInstance.data());
     connect(edgeInstance.data(),SIGNAL(statusUpdated(graph::BaseElement&,int)),this,SLOT(edgeDataRefChanged(graph::BaseElement&,int)));
     emit edgeCreated(edgeInstance);
     return edgeInstance;
@@ -158,12 +173,15 @@ namespace graph
 
   bool ElementManager::deleteVertexInstance(Vertex::Ptr vertex)
   {
-    if (!vertex.isNull() && vertex->safeToDelete() && vertexInstances.contains(vertex->dataRef()->signature(),vertex))
+    if (!vertex.isNull() && vertex->safeToDelete() && vertexIndex.contains(vertex.data()))
     {
       disconnect(vertex.data(),SIGNAL(statusUpdated(graph::BaseElement&,int)),this,SLOT(vertexDataRefChanged(graph::BaseElement&,int)));
       QMutexLocker lock(&mutex);
       emit vertexToBeDeleted(vertex);
-      return vertexInstances.remove(vertex->dataRef()->signature(),vertex) == 1;
+      IndexEntry<VertexInstanceMap::iterator> entry = vertexIndex.take(vertex.data());
+      vertexIds.remove(entry.id,vertex.data());
+      vertexInstances.erase(entry.instance);
+      return true;
     }
     else
     {
@@ -173,12 +191,15 @@ namespace graph
 
   bool ElementManager::deleteEdgeInstance(Edge::Ptr edge)
   {
-    if (!edge.isNull() && edge->safeToDelete() && edgeInstances.contains(edge->dataRef()->signature(),edge))
+    if (!edge.isNull() && edge->safeToDelete() && edgeIndex.contains(edge.data()))
     {
       disconnect(edge.data(),SIGNAL(statusUpdated(graph::BaseElement&,int)),this,SLOT(edgeDataRefChanged(graph::BaseElement&,int)));
       QMutexLocker lock(&mutex);
       emit edgeToBeDeleted(edge);
-      return edgeInstances.remove(edge->dataRef()->signature(),edge) == 1;
+      IndexEntry<EdgeInstanceMap::iterator> entry = edgeIndex.take(edge.data());
+      edgeIds.remove(entry.id,edge.data());
+      edgeInstances.erase(entry.instance);
+      return true;
     }
     else
     {
@@ -225,12 +246,10 @@ namespace graph
   Vertex::Ptr ElementManager::vertexFromId(const QUuid& id) const
   {
     QMutexLocker lock(&mutex);
-    for(VertexInstanceMap::const_iterator it = vertexInstances.begin(); it != vertexInstances.end(); ++it)
+    VertexIndex::const_iterator it = vertexIndex.constFind(vertexIds.value(id,0));
+    if (it != vertexIndex.constEnd())
     {
-      if (it.value()->id() == id)
-      {
-        return it.value();
-      }
+      return it.value().instance.value();
     }
     return Vertex::Ptr();
   }
@@ -238,47 +257,54 @@ namespace graph
   Edge::Ptr ElementManager::edgeFromId(const QUuid& id) const
   {
     QMutexLocker lock(&mutex);
-    for(EdgeInstanceMap::const_iterator it = edgeInstances.begin(); it != edgeInstances.end(); ++it)
+    EdgeIndex::const_iterator it = edgeIndex.constFind(edgeIds.value(id,0));
+    if (it != edgeIndex.constEnd())
     {
-      if (it.value()->id() == id)
-      {
-        return it.value();
-      }
+      return it.value().instance.value();
     }
     return Edge::Ptr();
   }
 
   void ElementManager::vertexDataRefChanged(graph::BaseElement& element,int reason)
   {
-    if (reason != BaseElement::DataRef) return;
+    if (reason != BaseElement::DataRef && reason != BaseElement::ElementId) return;
     QMutexLocker lock(&mutex);
-    Vertex& vertex = static_cast<Vertex&>(element);
-    for(VertexInstanceMap::iterator it = vertexInstances.begin(); it != vertexInstances.end(); ++it)
+    VertexIndex::iterator it = vertexIndex.find(&element);
+    if (it == vertexIndex.end()) return;
+    IndexEntry<VertexInstanceMap::iterator>& entry = it.value();
+    if (reason == BaseElement::ElementId)
     {
-      if (it.value()->id() == vertex.id())
-      {
-        Vertex::Ptr vertexPtr = it.value();
-        vertexInstances.erase(it);
-        vertexInstances.insert(vertexPtr->dataRef()->signature(),vertexPtr);
-        return;
-      }
+      // ids are assigned after creation when elements are loaded or pasted
+      vertexIds.remove(entry.id,&element);
+      entry.id = element.id();
+      vertexIds.insert(entry.id,&element);
+    }
+    else
+    {
+      Vertex::Ptr vertexPtr = entry.instance.value();
+      vertexInstances.erase(entry.instance);
+      entry.instance = vertexInstances.insert(vertexPtr->dataRef()->signature(),vertexPtr);
     }
   }
 
   void ElementManager::edgeDataRefChanged(graph::BaseElement& element,int reason)
   {
-    if (reason != BaseElement::DataRef) return;
+    if (reason != BaseElement::DataRef && reason != BaseElement::ElementId) return;
     QMutexLocker lock(&mutex);
-    Edge& edge = static_cast<Edge&>(element);
-    for(EdgeInstanceMap::iterator it = edgeInstances.begin(); it != edgeInstances.end(); ++it)
+    EdgeIndex::iterator it = edgeIndex.find(&element);
+    if (it == edgeIndex.end()) return;
+    IndexEntry<EdgeInstanceMap::iterator>& entry = it.value();
+    if (reason == BaseElement::ElementId)
     {
-      if (it.value()->id() == edge.id())
-      {
-        Edge::Ptr edgePtr = it.value();
-        edgeInstances.erase(it);
-        edgeInstances.insert(edgePtr->dataRef()->signature(),edgePtr);
-        return;
-      }
+      edgeIds.remove(entry.id,&element);
+      entry.id = element.id();
+      edgeIds.insert(entry.id,&element);
+    }
+    else
+    {
+      Edge::Ptr edgePtr = entry.instance.value();
+      edgeInstances.erase(entry.instance);
+      entry.instance = edgeInstances.insert(edgePtr->dataRef()->signature(),edgePtr);
     }
   }
 
@@ -299,14 +325,63 @@ namespace graph
     }
   }
 
+  //-----------------------------------------------------------------------
+  // Class Adjacency
+  //-----------------------------------------------------------------------
+  Adjacency::Adjacency(const QMap<QUuid,Vertex::Ptr>& vertexMap) : vertexList(), indexMap(), succOffset(), succVertex(), succEdge(), predOffset(), predVertex(), predEdge()
+  {
+    vertexList.reserve(vertexMap.size());
+    indexMap.reserve(vertexMap.size());
+    for(QMap<QUuid,Vertex::Ptr>::const_iterator it = vertexMap.begin(); it != vertexMap.end(); ++it)
+    {
+      indexMap.insert(it.value().data(),vertexList.size());
+      vertexList.append(it.value());
+    }
+    succOffset.reserve(vertexList.size() + 1);
+    predOffset.reserve(vertexList.size() + 1);
+    for(int i = 0; i < vertexList.size(); ++i)
+    {
+      const Vertex::EdgeRefMap& edgeRefs = vertexList[i]->edges();
+      succOffset.append(succVertex.size());
+      for(Vertex::EdgeRefMap::const_iterator it = edgeRefs.constFind(Defines::Outgoing); it != edgeRefs.constEnd() && it.key() == Defines::Outgoing; ++it)
+      {
+        int j = index(&it.value()->destPin()->vertex());
+        if (j < 0) continue;
+        succVertex.append(j);
+        succEdge.append(it.value().data());
+      }
+      predOffset.append(predVertex.size());
+      for(Vertex::EdgeRefMap::const_iterator it = edgeRefs.constFind(Defines::Incoming); it != edgeRefs.constEnd() && it.key() == Defines::Incoming; ++it)
+      {
+        int j = index(&it.value()->srcPin()->vertex());
+        if (j < 0) continue;
+        predVertex.append(j);
+        predEdge.append(it.value().data());
+      }
+    }
+    succOffset.append(succVertex.size());
+    predOffset.append(predVertex.size());
+  }
+
   //-----------------------------------------------------------------------
   // Class GraphBase
   //-----------------------------------------------------------------------
   GraphBase::GraphBase() : QObject(0), Serializer("graph",GraphBase::staticMetaObject.propertyOffset(),this), vertices(), edges(), graphName(), graphId(QUuid::createUuid()), lockId(),
-    graphScene(), mutex(QMutex::Recursive)
+    graphScene(), mutex(QMutex::Recursive), adjacencySnapshot(), updateLevel(0), updatesPending(),
+    componentParent(), componentSize(), componentsValid(true), componentMap(), componentMapValid(false)
   {
   }
 
+  Adjacency::Ptr GraphBase::adjacency() const
+  {
+    QMutexLocker lock(&mutex);
+    if (adjacencySnapshot.isNull())
+    {
+      adjacencySnapshot = Adjacency::Ptr(new Adjacency(vertices));
+    }
+    return adjacencySnapshot;
+  }
+
   Scene::Ptr GraphBase::scene()
   {
     if (graphScene.isNull())
@@ -327,9 +402,13 @@ namespace graph
       handler->setGraphReference(this);
       handler->setFlagDelete(false);
       vertices.insert(vertex->id(), vertex);
+      adjacencySnapshot.clear();
+      componentParent.insert(vertex.data(),vertex.data());
+      componentSize.insert(vertex.data(),1);
+      componentMapValid = false;
       connect(vertex.data(),SIGNAL(statusUpdated(graph::BaseElement&,int)),this,SLOT(vertexChanged(graph::BaseElement&,int)));
       emit vertexAdded(vertex);
-      emit statusUpdated((int)CountVertices);
+      notifyStatus(CountVertices);
       return true;
     }
     return false;
@@ -346,8 +425,13 @@ namespace graph
       handler->setFlagDelete(true);
       emit vertexToBeRemoved(vertex);
       vertices.remove(vertex->id());
+      adjacencySnapshot.clear();
+      // a vertex without edges forms a component of its own
+      componentParent.remove(vertex.data());
+      componentSize.remove(vertex.data());
+      componentMapValid = false;
       disconnect(vertex.data(),SIGNAL(statusUpdated(graph::BaseElement&,int)),this,SLOT(vertexChanged(graph::BaseElement&,int)));
-      emit statusUpdated((int)CountVertices);
+      notifyStatus(CountVertices);
       return true;
     }
     return false;
@@ -373,8 +457,14 @@ namespace graph
       handlerSrcPin->incConnections();
       handlerDestPin->incConnections();
       edges.insert(edge->id(), edge);
+      adjacencySnapshot.clear();
+      if (componentsValid)
+      {
+        joinComponents(&edge->srcPin()->vertex(),&edge->destPin()->vertex());
+      }
+      componentMapValid = false;
       emit edgeAdded(edge);
-      emit statusUpdated((int)CountEdges);
+      notifyStatus(CountEdges);
       return true;
     }
     return false;
@@ -399,12 +489,62 @@ namespace graph
       handlerDestPin->decConnections();
       emit edgeToBeRemoved(edge);
       edges.remove(edge->id());
-      emit statusUpdated((int)CountEdges);
+      adjacencySnapshot.clear();
+      // within a transaction all components are rebuilt once when they are needed next
+      if (updateLevel > 0)
+      {
+        componentsValid = false;
+      }
+      else if (componentsValid)
+      {
+        splitComponent(&edge->srcPin()->vertex(),&edge->destPin()->vertex());
+      }
+      componentMapValid = false;
+      notifyStatus(CountEdges);
       return true;
     }
     return false;
   }
 
+  void GraphBase::beginUpdate()
+  {
+    QMutexLocker lock(&mutex);
+    updateLevel++;
+  }
+
+  void GraphBase::endUpdate()
+  {
+    QMutexLocker lock(&mutex);
+    Q_ASSERT_X(updateLevel > 0,"graph::GraphBase::endUpdate","No transaction started.");
+    if (updateLevel > 1)
+    {
+      updateLevel--;
+      return;
+    }
+    // receivers still see an active transaction while the collected changes are emitted
+    while(!updatesPending.isEmpty())
+    {
+      emit statusUpdated(updatesPending.takeFirst());
+    }
+    updateLevel = 0;
+    updateFinished();
+  }
+
+  void GraphBase::notifyStatus(int change)
+  {
+    if (updateLevel > 0)
+    {
+      if (!updatesPending.contains(change))
+      {
+        updatesPending.append(change);
+      }
+    }
+    else
+    {
+      emit statusUpdated(change);
+    }
+  }
+
   void GraphBase::save(QXmlStreamWriter& stream) const
   {
     stream.setAutoFormatting(true);
@@ -432,6 +572,14 @@ namespace graph
   }
 
   bool GraphBase::load(QXmlStreamReader& stream, ElementManager& manager)
+  {
+    beginUpdate();
+    bool result = loadElements(stream,manager);
+    endUpdate();
+    return result;
+  }
+
+  bool GraphBase::loadElements(QXmlStreamReader& stream, ElementManager& manager)
   {
     if (stream.readNextStartElement())
     {
@@ -447,7 +595,7 @@ namespace graph
       // all properties should have been processed here, now try to read vertices and edges
       QMap<QUuid,Pin::Ptr> pinMap;
       QStringList msgWarningsVertices;
-      if (stream.readNextStartElement() && stream.name() == "vertices") // if element is "vertices" then read vertices
+      if (readNextStartElement(stream) && stream.name() == "vertices") // if element is "vertices" then read vertices
       {
         while(stream.readNextStartElement())
         {
@@ -537,55 +685,214 @@ namespace graph
       }
       if (!readElementEnd(stream)) return false;
 
-      QString warnings;
-      if (msgWarningsVertices.count() > 0)
+      QString warnings = loadWarnings(msgWarningsVertices,msgWarningsEdges);
+      if (!warnings.isEmpty())
       {
-        if (msgWarningsVertices.count() == 1)
+        if (countVertices() > 0)
         {
-          warnings += QString(tr("%1 warning occurred while loading vertices:\n")).arg(msgWarningsVertices.count());
+          stream.raiseError(warnings);
         }
         else
         {
-          warnings += QString(tr("%1 warnings occurred while loading vertices:\n")).arg(msgWarningsVertices.count());
+          warnings += '\n' + tr("Graph does not contain any vertices.");
+          stream.raiseError(warnings);
+          return false;
         }
-        warnings += msgWarningsVertices.join('\n');
       }
-      if (msgWarningsEdges.count() > 0)
-      {
-        if (!warnings.isEmpty()) warnings += '\n';
+    }
+    else
+    {
+      stream.raiseError(QString(QObject::tr("At line %1, column %2: Failed to read root element. Is document empty?")).arg(stream.lineNumber()).arg(stream.columnNumber()));
+      return false;
+    }
+    return true;
+  }
+
+  void GraphBase::save(BinaryWriter& stream) const
+  {
+    stream.setSection(BinaryFormat::Graph);
+    writeElementStart(stream);
+    stream.writeUuid(graphId);
+    writeProperties(stream);
+    writeElementEnd(stream); // graph
 
-        if (msgWarningsEdges.count() == 1)
+    // signatures and pin ids precede the element records, so instances can be created before loading them
+    stream.setSection(BinaryFormat::Vertices);
+    stream.writeUInt32(vertices.count());
+    for(VertexMap::const_iterator it = vertices.begin(); it != vertices.end(); ++it)
+    {
+      VertexData::Ptr data = it.value()->dataRef();
+      stream.writeString(data.isNull() ? QString() : data->signature());
+      it.value()->save(stream);
+    }
+    stream.setSection(BinaryFormat::Edges);
+    stream.writeUInt32(edges.count());
+    for(EdgeMap::const_iterator it = edges.begin(); it != edges.end(); ++it)
+    {
+      EdgeData::Ptr data = it.value()->dataRef();
+      stream.writeString(data.isNull() ? QString() : data->signature());
+      stream.writeUuid(it.value()->srcPin().data()->id());
+      stream.writeUuid(it.value()->destPin().data()->id());
+      it.value()->save(stream);
+    }
+  }
+
+  bool GraphBase::load(BinaryReader& stream, ElementManager& manager)
+  {
+    beginUpdate();
+    bool result = loadElements(stream,manager);
+    endUpdate();
+    return result;
+  }
+
+  bool GraphBase::loadElements(BinaryReader& stream, ElementManager& manager)
+  {
+    if (!stream.setSection(BinaryFormat::Graph)) return false;
+    if (!readElementStart(stream)) return false;
+    graphId = stream.readUuid();
+    if (graphId.isNull())
+    {
+      stream.raiseError(QString(QObject::tr("At offset %1: Graph has an invalid id '%2'.")).arg(stream.offset()).arg(graphId.toString()));
+      return false;
+    }
+    if (!readProperties(stream)) return false;
+    if (!readElementEnd(stream)) return false;
+
+    // load vertices and keep track of all pins created for the edges to load
+    QHash<QUuid,Pin::Ptr> pinMap;
+    QStringList msgWarningsVertices;
+    if (!stream.setSection(BinaryFormat::Vertices)) return false;
+    quint32 vertexCount = stream.readUInt32();
+    for(quint32 i = 0; i < vertexCount && !stream.hasError(); ++i)
+    {
+      QString signature = stream.readString();
+      if (signature.isEmpty())
+      {
+        stream.raiseError(QString(tr("At offset %1: Missing or undefined signature for vertex.")).arg(stream.offset()));
+        return false;
+      }
+      Vertex::Ptr vertexPtr = manager.createVertexInstance(signature);
+      if (!vertexPtr.isNull())
+      {
+        if (signature != vertexPtr->dataRef()->signature())
         {
-          warnings += QString(tr("%1 warning occurred while loading edges:\n")).arg(msgWarningsEdges.count());
+          msgWarningsVertices.append(QString(tr("at offset %1: Vertex with signature \"%2\" was substituted by vertex with signature \"%3\".")).arg(stream.offset()).arg(signature).arg(vertexPtr->dataRef()->signature()));
         }
-        else
+        if (!(vertexPtr->load(stream) && addVertex(vertexPtr)))
         {
-          warnings += QString(tr("%1 warnings occurred while loading edges:\n")).arg(msgWarningsEdges.count());
+          manager.deleteVertexInstance(vertexPtr);
+          return false;
+        }
+        const Vertex::PinMap& pins = vertexPtr->pins();
+        for(Vertex::PinMap::const_iterator it = pins.begin(); it != pins.end(); ++it)
+        {
+          pinMap.insert(it.value()->id(),it.value());
         }
-        warnings += msgWarningsEdges.join('\n');
       }
-      if (!warnings.isEmpty())
+      else
       {
-        if (countVertices() > 0)
+        msgWarningsVertices.append(QString(tr("at offset %1: Vertex with unknown signature \"%2\" not created.")).arg(stream.offset()).arg(signature));
+        stream.skipRecord();
+      }
+    }
+    // load edges
+    QStringList msgWarningsEdges;
+    if (!stream.setSection(BinaryFormat::Edges)) return false;
+    quint32 edgeCount = stream.readUInt32();
+    for(quint32 i = 0; i < edgeCount && !stream.hasError(); ++i)
+    {
+      QString signature = stream.readString();
+      QUuid pinSrcId = stream.readUuid();
+      QUuid pinDstId = stream.readUuid();
+      if (signature.isEmpty())
+      {
+        stream.raiseError(QString(tr("At offset %1: Missing or undefined signature for edge.")).arg(stream.offset()));
+        return false;
+      }
+      QHash<QUuid,Pin::Ptr>::const_iterator itSrc = pinMap.constFind(pinSrcId);
+      QHash<QUuid,Pin::Ptr>::const_iterator itDst = pinMap.constFind(pinDstId);
+      if (itSrc != pinMap.constEnd() && itDst != pinMap.constEnd())
+      {
+        Edge::Ptr edgePtr = manager.createEdgeInstance(itSrc.value().toWeakRef(),itDst.value().toWeakRef(),signature);
+        if (!edgePtr.isNull())
         {
-          stream.raiseError(warnings);
+          if (edgePtr->load(stream))
+          {
+            if (!addEdge(edgePtr))
+            {
+              msgWarningsEdges.append(QString(tr("at offset %1: Edge with signature \"%2\" trying to connect incompatible pins.")).arg(stream.offset()).arg(signature));
+              manager.deleteEdgeInstance(edgePtr);
+            }
+          }
+          else
+          {
+            manager.deleteEdgeInstance(edgePtr);
+            return false;
+          }
         }
         else
         {
-          warnings += '\n' + tr("Graph does not contain any vertices.");
-          stream.raiseError(warnings);
-          return false;
+          msgWarningsEdges.append(QString(tr("at offset %1: Edge with unknown signature \"%2\" not created.")).arg(stream.offset()).arg(signature));
+          stream.skipRecord();
         }
       }
+      else
+      {
+        msgWarningsEdges.append(QString(tr("at offset %1: Source or destination pin not defined for edge with signature \"%2\".")).arg(stream.offset()).arg(signature));
+        stream.skipRecord();
+      }
     }
-    else
+    if (stream.hasError()) return false;
+
+    QString warnings = loadWarnings(msgWarningsVertices,msgWarningsEdges);
+    if (!warnings.isEmpty())
     {
-      stream.raiseError(QString(QObject::tr("At line %1, column %2: Failed to read root element. Is document empty?")).arg(stream.lineNumber()).arg(stream.columnNumber()));
-      return false;
+      if (countVertices() > 0)
+      {
+        stream.raiseError(warnings);
+      }
+      else
+      {
+        warnings += '\n' + tr("Graph does not contain any vertices.");
+        stream.raiseError(warnings);
+        return false;
+      }
     }
     return true;
   }
 
+  QString GraphBase::loadWarnings(const QStringList& msgWarningsVertices, const QStringList& msgWarningsEdges) const
+  {
+    QString warnings;
+    if (msgWarningsVertices.count() > 0)
+    {
+      if (msgWarningsVertices.count() == 1)
+      {
+        warnings += QString(tr("%1 warning occurred while loading vertices:\n")).arg(msgWarningsVertices.count());
+      }
+      else
+      {
+        warnings += QString(tr("%1 warnings occurred while loading vertices:\n")).arg(msgWarningsVertices.count());
+      }
+      warnings += msgWarningsVertices.join('\n');
+    }
+    if (msgWarningsEdges.count() > 0)
+    {
+      if (!warnings.isEmpty()) warnings += '\n';
+
+      if (msgWarningsEdges.count() == 1)
+      {
+        warnings += QString(tr("%1 warning occurred while loading edges:\n")).arg(msgWarningsEdges.count());
+      }
+      else
+      {
+        warnings += QString(tr("%1 warnings occurred while loading edges:\n")).arg(msgWarningsEdges.count());
+      }
+      warnings += msgWarningsEdges.join('\n');
+    }
+    return warnings;
+  }
+
   void GraphBase::vertexChanged(graph::BaseElement& element, int reason)
   {
     QMutexLocker lock(&mutex);
@@ -605,76 +912,205 @@ namespace graph
         }
       }
       // remove invalid egdes from graph
+      beginUpdate();
       foreach(Edge::Ptr ptr,invalidEdges)
       {
         removeEdge(ptr);
       }
+      endUpdate();
     }
   }
 
   const GraphBase::ComponentMap GraphBase::components() const
   {
-    QMutexLocker    lock(&mutex);
-    QMap<QUuid,int> componentIdMap;
-    int             compNr = 0;
-    foreach(Vertex::Ptr vertex, vertices)
+    QMutexLocker lock(&mutex);
+    if (!componentsValid)
     {
-      if (!componentIdMap.contains(vertex->id()))
+      rebuildComponents();
+    }
+    if (!componentMapValid)
+    {
+      QHash<Vertex*,int> compNr;
+      componentMap.clear();
+      foreach(Vertex::Ptr vertex, vertices)
       {
-        visitVertex(vertex.data(),compNr++,componentIdMap);
+        Vertex* root = componentRoot(vertex.data());
+        QHash<Vertex*,int>::const_iterator it = compNr.constFind(root);
+        if (it == compNr.constEnd())
+        {
+          it = compNr.insert(root,compNr.size());
+        }
+        componentMap.insert(it.value(),vertex);
       }
+      componentMapValid = true;
+    }
+    return componentMap;
+  }
+
+  int GraphBase::countComponents() const
+  {
+    QMutexLocker lock(&mutex);
+    if (!componentsValid)
+    {
+      rebuildComponents();
     }
-    ComponentMap compMap;
-    foreach(Vertex::Ptr vertex, vertices)
+    return componentSize.size();
+  }
+
+  Vertex* GraphBase::componentRoot(Vertex* vertex) const
+  {
+    // path halving keeps the trees flat
+    Vertex* parent = componentParent.value(vertex);
+    while(parent != vertex)
     {
-      compMap.insert(componentIdMap[vertex->id()],vertex);
+      Vertex* grandParent = componentParent.value(parent);
+      componentParent[vertex] = grandParent;
+      vertex = parent;
+      parent = grandParent;
     }
-    return compMap;
+    return vertex;
   }
 
-  void GraphBase::visitVertex(Vertex* vertex, int compNr, QMap<QUuid,int>& components) const
+  void GraphBase::joinComponents(Vertex* vertex1, Vertex* vertex2)
   {
-    components.insert(vertex->id(),compNr);
-    Vertex::EdgeRefList edgeList = vertex->edges(Defines::Outgoing);
-    foreach(Edge::Ptr edgeRef,edgeList)
+    Vertex* root1 = componentRoot(vertex1);
+    Vertex* root2 = componentRoot(vertex2);
+    if (root1 == root2) return;
+    // union by size
+    if (componentSize.value(root1) < componentSize.value(root2))
+    {
+      qSwap(root1,root2);
+    }
+    int size = componentSize.take(root2);
+    componentParent[root2] = root1;
+    componentSize[root1] += size;
+  }
+
+  void GraphBase::splitComponent(Vertex* vertex1, Vertex* vertex2)
+  {
+    // Called after an edge between both vertices was removed. The part of the component which is still
+    // reachable from vertex1 is searched. If it does not contain vertex2, both parts get a new root.
+    if (vertex1 == vertex2) return;
+    QVector<Vertex*> part1;
+    QSet<Vertex*> reached;
+    part1.append(vertex1);
+    reached.insert(vertex1);
+    for(int head = 0; head < part1.size(); ++head)
     {
-      Vertex& v = edgeRef->destPin()->vertex();
-      if (!components.contains(v.id()))
+      const Vertex::EdgeRefMap& edgeRefs = part1[head]->edges();
+      for(Vertex::EdgeRefMap::const_iterator it = edgeRefs.begin(); it != edgeRefs.end(); ++it)
       {
-        visitVertex(&v,compNr,components);
+        Vertex* v = (it.key() == Defines::Outgoing) ? &it.value()->destPin()->vertex() : &it.value()->srcPin()->vertex();
+        if (v == vertex2) return;
+        if (!reached.contains(v))
+        {
+          reached.insert(v);
+          part1.append(v);
+        }
       }
     }
-    edgeList = vertex->edges(Defines::Incoming);
-    foreach(Edge::Ptr edgeRef,edgeList)
+    QVector<Vertex*> part2;
+    part2.append(vertex2);
+    reached.insert(vertex2);
+    for(int head = 0; head < part2.size(); ++head)
+    {
+      const Vertex::EdgeRefMap& edgeRefs = part2[head]->edges();
+      for(Vertex::EdgeRefMap::const_iterator it = edgeRefs.begin(); it != edgeRefs.end(); ++it)
+      {
+        Vertex* v = (it.key() == Defines::Outgoing) ? &it.value()->destPin()->vertex() : &it.value()->srcPin()->vertex();
+        if (!reached.contains(v))
+        {
+          reached.insert(v);
+          part2.append(v);
+        }
+      }
+    }
+    componentSize.remove(componentRoot(vertex1));
+    foreach(Vertex* v, part1)
+    {
+      componentParent[v] = vertex1;
+    }
+    foreach(Vertex* v, part2)
+    {
+      componentParent[v] = vertex2;
+    }
+    componentSize.insert(vertex1,part1.size());
+    componentSize.insert(vertex2,part2.size());
+  }
+
+  void GraphBase::rebuildComponents() const
+  {
+    // breadth first search along edges in both directions starting at each vertex not yet assigned
+    Adjacency::Ptr snapshot = adjacency();
+    const int      count = snapshot->countVertices();
+    QVector<bool>  assigned(count,false);
+    QVector<int>   queue;
+    queue.reserve(count);
+    componentParent.clear();
+    componentSize.clear();
+    for(int root = 0; root < count; ++root)
     {
-      Vertex& v = edgeRef->srcPin()->vertex();
-      if (!components.contains(v.id()))
+      if (assigned[root]) continue;
+      Vertex* rootVertex = snapshot->vertex(root).data();
+      assigned[root] = true;
+      queue.resize(0);
+      queue.append(root);
+      for(int head = 0; head < queue.size(); ++head)
       {
-        visitVertex(&v,compNr,components);
+        int v = queue[head];
+        componentParent.insert(snapshot->vertex(v).data(),rootVertex);
+        for(int pos = snapshot->succBegin(v); pos < snapshot->succEnd(v); ++pos)
+        {
+          int w = snapshot->successor(pos);
+          if (!assigned[w])
+          {
+            assigned[w] = true;
+            queue.append(w);
+          }
+        }
+        for(int pos = snapshot->predBegin(v); pos < snapshot->predEnd(v); ++pos)
+        {
+          int w = snapshot->predecessor(pos);
+          if (!assigned[w])
+          {
+            assigned[w] = true;
+            queue.append(w);
+          }
+        }
       }
+      componentSize.insert(rootVertex,queue.size());
     }
+    componentsValid = true;
   }
 
   //-----------------------------------------------------------------------
   // Class DirectedGraph
   //-----------------------------------------------------------------------
   DirectedGraph::DirectedGraph() : GraphBase(), vertexInfo(),
-    topologicalOrderMap(), topologicalOrderUpdatedRequired(false), topologicalOrderAutoUpdate(true),
-    strongComponentMap(), strongComponentsUpdatedRequired(false), strongComponentsAutoUpdate(false)
+    topologicalOrderMap(), topologicalOrderUpdatedRequired(false), topologicalOrderAutoUpdate(true), topologicalOrderIncremental(true),
+    strongComponentMap(), strongComponentsUpdatedRequired(false), strongComponentsAutoUpdate(false),
+    linearChainList(), linearChainIndex(), linearChainsValid(false)
   {
     connect(this,SIGNAL(statusUpdated(int)),this,SLOT(graphChanged(int)));
+    connect(this,SIGNAL(vertexAdded(Vertex::Ptr)),this,SLOT(onVertexAdded(Vertex::Ptr)));
+    connect(this,SIGNAL(vertexToBeRemoved(Vertex::Ptr)),this,SLOT(onVertexToBeRemoved(Vertex::Ptr)));
+    connect(this,SIGNAL(edgeAdded(Edge::Ptr)),this,SLOT(onEdgeAdded(Edge::Ptr)));
+    connect(this,SIGNAL(edgeToBeRemoved(Edge::Ptr)),this,SLOT(onEdgeToBeRemoved(Edge::Ptr)));
   }
 
   DirectedGraph::~DirectedGraph()
   {
     topologicalOrderMap.clear();
     strongComponentMap.clear();
+    linearChainList.clear();
+    linearChainIndex.clear();
   }
 
   int DirectedGraph::strongComponentsCount()
   {
+    // components are numbered consecutively starting with 0
     const ComponentMap& comps = strongComponents();
-    return comps.uniqueKeys().size();
+    return (comps.isEmpty()) ? 0 : comps.lastKey() + 1;
   }
 
   bool DirectedGraph::strongComponent(int index, GraphBase::ComponentMap& result)
@@ -682,7 +1118,7 @@ namespace graph
     result.clear();
     const ComponentMap& comps = strongComponents();
     QMutexLocker lock(&mutex);
-    if (index >= comps.uniqueKeys().size())
+    if (comps.isEmpty() || index > comps.lastKey())
     {
       return false;
     }
@@ -702,55 +1138,134 @@ namespace graph
       return topologicalOrderMap;
     }
     topologicalOrderUpdatedRequired = false;
-    topologicalOrderMap.clear();
-    // get all vertices without predecessor -> starting vertices
-    QList<Vertex*> startVertices;
-    for(VertexMap::iterator it = vertices.begin(); it != vertices.end(); ++it)
+    // changes of acyclic graphs were already applied to the order by the slots for added and removed elements
+    if (!topologicalOrderIncremental)
     {
-      if (it.value()->edges().count(Defines::Incoming) == 0)
-      {
-        startVertices.append(it.value().data());
-      }
+      rebuildTopologicalOrder();
     }
-    // now start labeling the vertices starting at startVertices
+    linearChainsValid = false;
+    // trigger scene update if there is a scene
+    if (hasScene()) scene()->update();
+    emit statusUpdated(TopologicalOrder);
+    return topologicalOrderMap;
+  }
+
+  void DirectedGraph::rebuildTopologicalOrder()
+  {
+    topologicalOrderMap.clear();
     vertexInfo.clear();
-    QSet<Vertex*> visitedVertices;
-    foreach(Vertex* v,startVertices)
+    // acyclic graphs are labeled by a single pass and updated incrementally afterwards,
+    // graphs with cycles are labeled on their strong components
+    topologicalOrderIncremental = orderAcyclicVertices(vertexInfo);
+    if (!topologicalOrderIncremental)
     {
-      visitVertex(v,visitedVertices,0,vertexInfo);
+      vertexInfo.clear();
+      orderCyclicVertices(vertexInfo);
     }
-    // if we generated the same number of vertex information as the number of vertices in the graph
-    // we are done, otherwise we'll have to investigate the strong components
-    if (vertexInfo.size() != vertices.size())
+    // finally write result into map
+    for(VertexMap::iterator it = vertices.begin(); it != vertices.end(); ++it)
     {
-      // look for strongly connected components
-      const ComponentMap& components = strongComponents();
-      startVertices.clear();
-      // get all vertices which have forced topological order and are in a cycle
-      for(ComponentMap::const_iterator it = components.begin(); it != components.end(); ++it)
+      topologicalOrderMap.insert(vertexInfo[it.value()->id()].order,it.value());
+    }
+  }
+
+  bool DirectedGraph::relabelVertices(Vertex* start, Vertex* cycleVertex)
+  {
+    // Recomputes the longest path length of start and of all vertices behind it whose length changes.
+    // Vertices are visited by their old labels which form a valid topological order of the old graph,
+    // so all predecessors of a vertex are final when it is relabeled. If cycleVertex has to be
+    // relabeled, the new edge to start closed a cycle and false is returned.
+    QMultiMap<int,Vertex*> queue;
+    QSet<Vertex*> queued;
+    queue.insert(vertexInfo.value(start->id()).order,start);
+    queued.insert(start);
+    while(!queue.isEmpty())
+    {
+      QMultiMap<int,Vertex*>::iterator first = queue.begin();
+      Vertex* vertex = first.value();
+      queue.erase(first);
+      int order = 0;
+      const Vertex::EdgeRefMap& edgeRefs = vertex->edges();
+      for(Vertex::EdgeRefMap::const_iterator it = edgeRefs.constFind(Defines::Incoming); it != edgeRefs.constEnd() && it.key() == Defines::Incoming; ++it)
       {
-        vertexInfo[it.value()->id()].inCycle = true;
-        if (it.value()->topologicalOrderForced())
-        {
-          startVertices.append(it.value().data());
-        }
+        order = qMax(order,vertexInfo.value(it.value()->srcPin()->vertex().id()).order + 1);
       }
-      // now label new set of vertices
-      visitedVertices.clear();
-      foreach(Vertex* v,startVertices)
+      DirectedVertexInfo& info = vertexInfo[vertex->id()];
+      if (order == info.order) continue;
+      if (vertex == cycleVertex) return false;
+      Vertex::Ptr vertexRef = vertices.value(vertex->id());
+      topologicalOrderMap.remove(info.order,vertexRef);
+      topologicalOrderMap.insert(order,vertexRef);
+      info.order = order;
+      for(Vertex::EdgeRefMap::const_iterator it = edgeRefs.constFind(Defines::Outgoing); it != edgeRefs.constEnd() && it.key() == Defines::Outgoing; ++it)
       {
-        visitVertex(v,visitedVertices,0,vertexInfo);
+        Vertex* successor = &it.value()->destPin()->vertex();
+        if (!queued.contains(successor))
+        {
+          queue.insert(vertexInfo.value(successor->id()).order,successor);
+          queued.insert(successor);
+        }
       }
     }
-    // finally write result into map
-    for(VertexMap::iterator it = vertices.begin(); it != vertices.end(); ++it)
+    return true;
+  }
+
+  void DirectedGraph::onVertexAdded(Vertex::Ptr vertex)
+  {
+    QMutexLocker lock(&mutex);
+    if (!topologicalOrderIncremental) return;
+    // a new vertex has no edges yet
+    vertexInfo[vertex->id()].order = 0;
+    topologicalOrderMap.insert(0,vertex);
+  }
+
+  void DirectedGraph::onVertexToBeRemoved(Vertex::Ptr vertex)
+  {
+    QMutexLocker lock(&mutex);
+    if (!topologicalOrderIncremental) return;
+    // only vertices without edges are removed
+    topologicalOrderMap.remove(vertexInfo.value(vertex->id()).order,vertex);
+    vertexInfo.remove(vertex->id());
+  }
+
+  void DirectedGraph::onEdgeAdded(Edge::Ptr edge)
+  {
+    QMutexLocker lock(&mutex);
+    if (!topologicalOrderIncremental) return;
+    // bulk changes without automatic update or within a transaction are cheaper to handle by a single rebuild
+    Vertex* src = &edge->srcPin()->vertex();
+    Vertex* dest = &edge->destPin()->vertex();
+    if (!topologicalOrderAutoUpdate || updateActive() || src == dest)
     {
-      topologicalOrderMap.insert(vertexInfo[it.value()->id()].order,it.value());
+      topologicalOrderIncremental = false;
+    }
+    else if (vertexInfo.value(src->id()).order >= vertexInfo.value(dest->id()).order)
+    {
+      topologicalOrderIncremental = relabelVertices(dest,src);
     }
-    // trigger scene update if there is a scene
-    if (hasScene()) scene()->update();
-    emit statusUpdated(TopologicalOrder);
-    return topologicalOrderMap;
+  }
+
+  void DirectedGraph::onEdgeToBeRemoved(Edge::Ptr edge)
+  {
+    QMutexLocker lock(&mutex);
+    if (!topologicalOrderIncremental) return;
+    if (!topologicalOrderAutoUpdate || updateActive())
+    {
+      topologicalOrderIncremental = false;
+    }
+    else
+    {
+      // the edge reference is already removed from both vertices
+      relabelVertices(&edge->destPin()->vertex(),0);
+    }
+  }
+
+  const DirectedGraph::LinearChainList& DirectedGraph::linearChains()
+  {
+    QMutexLocker lock(&mutex);
+    topologicalOrder();
+    if (!linearChainsValid) findLinearChains();
+    return linearChainList;
   }
 
   const GraphBase::ComponentMap& DirectedGraph::strongComponents()
@@ -762,16 +1277,7 @@ namespace graph
     }
     strongComponentsUpdatedRequired = false;
     strongComponentMap.clear();
-    QStack<Vertex*> vertexStack;
-    QMap<QUuid,int> visitedVertices;
-    int id = 0;
-    for(VertexMap::iterator it = vertices.begin(); it != vertices.end(); ++it)
-    {
-      if (!visitedVertices.contains(it.value()->id()))
-      {
-        visitVertex(it.value().data(),visitedVertices,id,vertices,vertexStack,strongComponentMap);
-      }
-    }
+    findStrongComponents(strongComponentMap);
     emit statusUpdated(StrongComponents);
     return strongComponentMap;
   }
@@ -783,7 +1289,7 @@ namespace graph
     if (reason == Vertex::TopologicalOrderForced)
     {
       topologicalOrderUpdatedRequired = true;
-      if (topologicalOrderAutoUpdate)
+      if (topologicalOrderAutoUpdate && !updateActive())
       {
         topologicalOrder();
       }
@@ -797,7 +1303,7 @@ namespace graph
     {
       case GraphBase::CountVertices:
         topologicalOrderUpdatedRequired = true;
-        if (topologicalOrderAutoUpdate)
+        if (topologicalOrderAutoUpdate && !updateActive())
         {
           topologicalOrder();
         }
@@ -805,11 +1311,11 @@ namespace graph
       case GraphBase::CountEdges:
         topologicalOrderUpdatedRequired = true;
         strongComponentsUpdatedRequired = true;
-        if (topologicalOrderAutoUpdate)
+        if (topologicalOrderAutoUpdate && !updateActive())
         {
           topologicalOrder();
         }
-        if (strongComponentsAutoUpdate && !topologicalOrderAutoUpdate)
+        if (strongComponentsAutoUpdate && !topologicalOrderAutoUpdate && !updateActive())
         {
           strongComponents();
         }
@@ -819,57 +1325,395 @@ namespace graph
     }
   }
 
-  void DirectedGraph::visitVertex(Vertex* vertex, QSet<Vertex*>& verticesVisited, int order, VertexInfoMap& vertexMap)
+  void DirectedGraph::updateFinished()
   {
-    if (vertexMap[vertex->id()].order <= order && !verticesVisited.contains(vertex))
+    // the updates deferred during the transaction are done once
+    QMutexLocker lock(&mutex);
+    if (topologicalOrderUpdatedRequired && topologicalOrderAutoUpdate)
+    {
+      topologicalOrder();
+    }
+    if (strongComponentsUpdatedRequired && strongComponentsAutoUpdate && !topologicalOrderAutoUpdate)
     {
-      vertexMap[vertex->id()].order = order;
-      verticesVisited.insert(vertex);
-      Vertex::EdgeRefList edgeList = vertex->edges(Defines::Outgoing);
-      foreach(Edge::Ptr edgeRef,edgeList)
+      strongComponents();
+    }
+  }
+
+  void DirectedGraph::findLinearChains() const
+  {
+    // called with locked mutex, uses the topological order as it is
+    linearChainList.clear();
+    linearChainIndex.clear();
+    QHash<Vertex*,Vertex*> nextVertex;
+    QSet<Vertex*> chainedVertices;
+    for(ComponentMap::const_iterator it = topologicalOrderMap.begin(); it != topologicalOrderMap.end(); ++it)
+    {
+      Vertex* u = it.value().data();
+      const DirectedVertexInfo infoU = vertexInfo.value(u->id());
+      if (infoU.order < 0 || infoU.inCycle) continue;
+      Vertex* v = uniqueNeighbour(u,Defines::Outgoing);
+      if (v == 0 || v == u) continue;
+      const DirectedVertexInfo infoV = vertexInfo.value(v->id());
+      if (infoV.order <= infoU.order || infoV.inCycle) continue;
+      if (uniqueNeighbour(v,Defines::Incoming) != u) continue;
+      nextVertex.insert(u,v);
+      chainedVertices.insert(v);
+    }
+    // every vertex with successor in chain but without predecessor in chain is head of a chain
+    for(ComponentMap::const_iterator it = topologicalOrderMap.begin(); it != topologicalOrderMap.end(); ++it)
+    {
+      Vertex* head = it.value().data();
+      if (!nextVertex.contains(head) || chainedVertices.contains(head)) continue;
+      LinearChain chain;
+      Vertex* v = head;
+      while(v != 0)
       {
-        Vertex& v = edgeRef->destPin()->vertex();
-        visitVertex(&v,verticesVisited,order + 1,vertexMap);
+        linearChainIndex.insert(v->id(),linearChainList.size());
+        chain.append(vertices.value(v->id()));
+        v = nextVertex.value(v,0);
       }
-      verticesVisited.remove(vertex);
+      linearChainList.append(chain);
     }
+    linearChainsValid = true;
   }
 
-  int DirectedGraph::visitVertex(Vertex* vertex, QMap<QUuid,int>& verticesVisited, int id, VertexMap& vertices, QStack<Vertex*>& stack, GraphBase::ComponentMap& components)
+  Vertex* DirectedGraph::uniqueNeighbour(Vertex* vertex, Defines::PinDirectionType direction) const
   {
-    int m, min;
-    verticesVisited[vertex->id()] = ++id;
-    min = id;
-    stack.push(vertex);
-    Vertex::EdgeRefList edgeList = vertex->edges(Defines::Outgoing);
+    Vertex* neighbour = 0;
+    Vertex::EdgeRefList edgeList = vertex->edges(direction);
     foreach(Edge::Ptr edgeRef,edgeList)
     {
-      Vertex& v = edgeRef->destPin()->vertex();
-      m = (!verticesVisited.contains(v.id())) ? visitVertex(&v,verticesVisited,id,vertices,stack,components) : verticesVisited[v.id()];
-      if (m < min) min = m;
+      Vertex* v = (direction == Defines::Outgoing) ? &edgeRef->destPin()->vertex() : &edgeRef->srcPin()->vertex();
+      if (neighbour != 0 && neighbour != v)
+      {
+        return 0;
+      }
+      neighbour = v;
     }
-    if (min == verticesVisited[vertex->id()])
+    return neighbour;
+  }
+
+  bool DirectedGraph::orderAcyclicVertices(VertexInfoMap& vertexMap) const
+  {
+    // Kahn's algorithm: a vertex is labeled with the length of the longest path reaching it
+    // as soon as all its predecessors are labeled. Returns false if a cycle is left over.
+    Adjacency::Ptr snapshot = adjacency();
+    const int count = snapshot->countVertices();
+    QVector<int> inDegree(count);
+    QVector<int> order(count,0);
+    QVector<int> queue;
+    queue.reserve(count);
+    for(int i = 0; i < count; ++i)
+    {
+      inDegree[i] = snapshot->inDegree(i);
+      if (inDegree[i] == 0)
+      {
+        queue.append(i);
+      }
+    }
+    for(int head = 0; head < queue.size(); ++head)
     {
-      int k = verticesVisited[vertex->id()];
-      // we are only interested in components consisting of more than one vertex
-      if (k != verticesVisited[stack.top()->id()])
+      int i = queue[head];
+      for(int pos = snapshot->succBegin(i); pos < snapshot->succEnd(i); ++pos)
       {
-        int componentId = components.uniqueKeys().size();
-        do
+        int j = snapshot->successor(pos);
+        if (order[i] + 1 > order[j])
         {
-          Vertex* vout = stack.pop();
-          components.insert(componentId,vertices[vout->id()]);
-          m = verticesVisited[vout->id()];
-          verticesVisited[vout->id()] = vertices.size() + 1;
-        } while(m != k);
+          order[j] = order[i] + 1;
+        }
+        if (--inDegree[j] == 0)
+        {
+          queue.append(j);
+        }
       }
-      else
+    }
+    if (queue.size() != count)
+    {
+      return false;
+    }
+    for(int i = 0; i < count; ++i)
+    {
+      vertexMap[snapshot->vertex(i)->id()].order = order[i];
+    }
+    return true;
+  }
+
+  void DirectedGraph::orderCyclicVertices(VertexInfoMap& vertexMap) const
+  {
+    // Kahn's algorithm on the condensation of the graph: a strong component is labeled as soon as all
+    // components in front of it are labeled. Inside a cyclic component a depth first search starting at
+    // the vertices entered from labeled predecessors, followed by the vertices with forced order, drops
+    // the edges closing a cycle and the remaining edges are labeled with longest path lengths. Cyclic
+    // components without such a vertex and all vertices only reachable through them stay unlabeled.
+    struct Frame
+    {
+      int vertex;
+      int nextEdge;
+    };
+    Adjacency::Ptr snapshot = adjacency();
+    const int count = snapshot->countVertices();
+    QVector<int> component;
+    const int componentCount = labelStrongComponents(snapshot,component);
+    // members of each component stored consecutively
+    QVector<int> memberOffset(componentCount + 1,0);
+    QVector<int> members(count);
+    QVector<int> componentInDegree(componentCount,0);
+    for(int v = 0; v < count; ++v)
+    {
+      memberOffset[component[v] + 1]++;
+      for(int pos = snapshot->succBegin(v); pos < snapshot->succEnd(v); ++pos)
+      {
+        if (component[snapshot->successor(pos)] != component[v])
+        {
+          componentInDegree[component[snapshot->successor(pos)]]++;
+        }
+      }
+    }
+    for(int c = 0; c < componentCount; ++c)
+    {
+      memberOffset[c + 1] += memberOffset[c];
+    }
+    QVector<int> fill(memberOffset);
+    for(int v = 0; v < count; ++v)
+    {
+      members[fill[component[v]]++] = v;
+    }
+    // vertices without predecessor start with 0, all others with the label of their predecessors
+    // in other components, -1 if none of them is labeled
+    QVector<int> order(count,-1);
+    for(int v = 0; v < count; ++v)
+    {
+      if (snapshot->inDegree(v) == 0)
+      {
+        order[v] = 0;
+      }
+    }
+    QVector<int> state(count,0);
+    QVector<bool> feedback(snapshot->countEdges(),false);
+    QVector<int> inDegree(count,0);
+    QVector<int> roots;
+    QVector<int> queue;
+    QVector<Frame> frames;
+    QVector<int> componentQueue;
+    componentQueue.reserve(componentCount);
+    for(int c = 0; c < componentCount; ++c)
+    {
+      if (componentInDegree[c] == 0)
+      {
+        componentQueue.append(c);
+      }
+    }
+    for(int head = 0; head < componentQueue.size(); ++head)
+    {
+      const int c = componentQueue[head];
+      const int first = memberOffset[c];
+      const int last = memberOffset[c + 1];
+      if (last - first > 1)
+      {
+        roots.resize(0);
+        for(int m = first; m < last; ++m)
+        {
+          if (order[members[m]] >= 0) roots.append(members[m]);
+        }
+        for(int m = first; m < last; ++m)
+        {
+          if (order[members[m]] < 0 && snapshot->vertex(members[m])->topologicalOrderForced())
+          {
+            order[members[m]] = 0;
+            roots.append(members[m]);
+          }
+        }
+        // state 1 marks vertices on the search path, edges to them close a cycle
+        foreach(int root, roots)
+        {
+          if (state[root] != 0) continue;
+          Frame rootFrame = { root, snapshot->succBegin(root) };
+          state[root] = 1;
+          frames.append(rootFrame);
+          while(!frames.isEmpty())
+          {
+            Frame& frame = frames.last();
+            if (frame.nextEdge < snapshot->succEnd(frame.vertex))
+            {
+              int pos = frame.nextEdge++;
+              int w = snapshot->successor(pos);
+              if (component[w] != c) continue;
+              if (state[w] == 1)
+              {
+                feedback[pos] = true;
+              }
+              else if (state[w] == 0)
+              {
+                state[w] = 1;
+                Frame childFrame = { w, snapshot->succBegin(w) };
+                frames.append(childFrame);
+              }
+              continue;
+            }
+            state[frame.vertex] = 2;
+            frames.removeLast();
+          }
+        }
+        // without a labeled or forced vertex no edge was dropped and the component stays unlabeled
+        if (!roots.isEmpty())
+        {
+          queue.resize(0);
+          for(int m = first; m < last; ++m)
+          {
+            int v = members[m];
+            for(int pos = snapshot->succBegin(v); pos < snapshot->succEnd(v); ++pos)
+            {
+              if (component[snapshot->successor(pos)] == c && !feedback[pos]) inDegree[snapshot->successor(pos)]++;
+            }
+          }
+          for(int m = first; m < last; ++m)
+          {
+            if (inDegree[members[m]] == 0) queue.append(members[m]);
+          }
+          for(int pos = 0; pos < queue.size(); ++pos)
+          {
+            int v = queue[pos];
+            for(int edge = snapshot->succBegin(v); edge < snapshot->succEnd(v); ++edge)
+            {
+              int w = snapshot->successor(edge);
+              if (component[w] != c || feedback[edge]) continue;
+              if (order[v] >= 0 && order[v] + 1 > order[w])
+              {
+                order[w] = order[v] + 1;
+              }
+              if (--inDegree[w] == 0)
+              {
+                queue.append(w);
+              }
+            }
+          }
+        }
+      }
+      // pass labels on to the following components
+      for(int m = first; m < last; ++m)
+      {
+        int v = members[m];
+        for(int pos = snapshot->succBegin(v); pos < snapshot->succEnd(v); ++pos)
+        {
+          int w = snapshot->successor(pos);
+          if (component[w] == c) continue;
+          if (order[v] >= 0 && order[v] + 1 > order[w])
+          {
+            order[w] = order[v] + 1;
+          }
+          if (--componentInDegree[component[w]] == 0)
+          {
+            componentQueue.append(component[w]);
+          }
+        }
+      }
+    }
+    for(int v = 0; v < count; ++v)
+    {
+      DirectedVertexInfo& info = vertexMap[snapshot->vertex(v)->id()];
+      info.order = order[v];
+      info.inCycle = (memberOffset[component[v] + 1] - memberOffset[component[v]] > 1);
+    }
+  }
+
+  void DirectedGraph::findStrongComponents(ComponentMap& components) const
+  {
+    // only components consisting of more than one vertex are reported, numbered consecutively
+    Adjacency::Ptr snapshot = adjacency();
+    const int count = snapshot->countVertices();
+    QVector<int> component;
+    const int componentCount = labelStrongComponents(snapshot,component);
+    QVector<int> size(componentCount,0);
+    for(int v = 0; v < count; ++v)
+    {
+      size[component[v]]++;
+    }
+    QVector<int> index(componentCount,-1);
+    int reported = 0;
+    for(int c = 0; c < componentCount; ++c)
+    {
+      if (size[c] > 1) index[c] = reported++;
+    }
+    for(int v = 0; v < count; ++v)
+    {
+      if (index[component[v]] >= 0)
       {
-        Vertex* vout = stack.pop();
-        verticesVisited[vout->id()] = vertices.size() + 1;
+        components.insert(index[component[v]],snapshot->vertex(v));
+      }
+    }
+  }
+
+  int DirectedGraph::labelStrongComponents(const Adjacency::Ptr& snapshot, QVector<int>& component) const
+  {
+    // Tarjan's algorithm with an explicit stack on dense vertex indices. Vertices are numbered in the
+    // order they are visited, numbering by depth in the search tree merges the low links of different
+    // branches and splits components. All vertices of a finished component get a number larger than
+    // any visit number. Every vertex gets the index of its component, components are finished in
+    // reverse topological order. Returns the number of components.
+    struct Frame
+    {
+      int vertex;
+      int nextEdge;
+      int min;
+    };
+    const int count = snapshot->countVertices();
+    const int finished = count + 1;
+    QVector<int> number(count,0);
+    QVector<int> vertexStack;
+    QVector<Frame> frames;
+    int componentCount = 0;
+    int visited = 0;
+    component.fill(-1,count);
+    for(int root = 0; root < count; ++root)
+    {
+      if (number[root] != 0) continue;
+      number[root] = ++visited;
+      Frame rootFrame = { root, snapshot->succBegin(root), number[root] };
+      vertexStack.append(root);
+      frames.append(rootFrame);
+      while(!frames.isEmpty())
+      {
+        Frame& frame = frames.last();
+        if (frame.nextEdge < snapshot->succEnd(frame.vertex))
+        {
+          int w = snapshot->successor(frame.nextEdge++);
+          if (number[w] == 0)
+          {
+            number[w] = ++visited;
+            vertexStack.append(w);
+            Frame childFrame = { w, snapshot->succBegin(w), number[w] };
+            frames.append(childFrame);
+          }
+          else if (number[w] < frame.min)
+          {
+            frame.min = number[w];
+          }
+          continue;
+        }
+        // all successors are visited
+        int v = frame.vertex;
+        int min = frame.min;
+        frames.removeLast();
+        if (min == number[v])
+        {
+          int k = number[v];
+          int m;
+          do
+          {
+            int vout = vertexStack.takeLast();
+            component[vout] = componentCount;
+            m = number[vout];
+            number[vout] = finished;
+          } while(m != k);
+          componentCount++;
+        }
+        if (!frames.isEmpty() && min < frames.last().min)
+        {
+          frames.last().min = min;
+        }
       }
     }
-    return min;
+    return componentCount;
   }
 
 }
@@ -28,9 +28,12 @@
 #include <QObject>
 #include <QUuid>
 #include <QList>
+#include <QStringList>
 #include <QMap>
-#include <QStack>
 #include <QMultiMap>
+#include <QHash>
+#include <QMultiHash>
+#include <QVector>
 #include <QMutex>
 #include <QSharedPointer>
 #include <QXmlStreamWriter>
@@ -97,10 +100,119 @@ namespace graph
     typedef QMultiMap<QString, Vertex::Ptr> VertexInstanceMap;
     typedef QMultiMap<QString, Edge::Ptr>   EdgeInstanceMap;
 
+    // index entry of an instance: its node in the instance map (QMap iterators stay valid
+    // until the node itself is erased) and the id it is currently indexed with
+    template<class Iterator> struct IndexEntry
+    {
+      Iterator instance;
+      QUuid    id;
+    };
+    typedef QHash<const BaseElement*,IndexEntry<VertexInstanceMap::iterator> > VertexIndex;
+    typedef QHash<const BaseElement*,IndexEntry<EdgeInstanceMap::iterator> >   EdgeIndex;
+    typedef QMultiHash<QUuid,const BaseElement*>                               IdIndex;
+
     VertexDataTypeMap vertexTypes;
     EdgeDataTypeMap   edgeTypes;
     VertexInstanceMap vertexInstances;
     EdgeInstanceMap   edgeInstances;
+    VertexIndex       vertexIndex;
+    EdgeIndex         edgeIndex;
+    IdIndex           vertexIds;
+    IdIndex           edgeIds;
+  };
+
+  // Immutable compressed sparse row snapshot of the graph structure. Vertices are numbered densely
+  // in the order of the graph's vertex map, the neighbours of vertex i are stored contiguously from
+  // succBegin(i) to succEnd(i) (predBegin(i) to predEnd(i) respectively) in the order of the vertex's
+  // edge references. Edge pointers are valid as long as the graph structure is not changed.
+  class Adjacency
+  {
+  public:
+    typedef QSharedPointer<const Adjacency> Ptr;
+
+    Adjacency(const QMap<QUuid,Vertex::Ptr>& vertexMap);
+
+    int countVertices() const
+    {
+      return vertexList.size();
+    }
+
+    int countEdges() const
+    {
+      return succVertex.size();
+    }
+
+    int index(const Vertex* vertex) const
+    {
+      return indexMap.value(vertex,-1);
+    }
+
+    const Vertex::Ptr& vertex(int index) const
+    {
+      return vertexList[index];
+    }
+
+    int succBegin(int index) const
+    {
+      return succOffset[index];
+    }
+
+    int succEnd(int index) const
+    {
+      return succOffset[index + 1];
+    }
+
+    int predBegin(int index) const
+    {
+      return predOffset[index];
+    }
+
+    int predEnd(int index) const
+    {
+      return predOffset[index + 1];
+    }
+
+    int outDegree(int index) const
+    {
+      return succOffset[index + 1] - succOffset[index];
+    }
+
+    int inDegree(int index) const
+    {
+      return predOffset[index + 1] - predOffset[index];
+    }
+
+    int successor(int pos) const
+    {
+      return succVertex[pos];
+    }
+
+    int predecessor(int pos) const
+    {
+      return predVertex[pos];
+    }
+
+    Edge* outEdge(int pos) const
+    {
+      return succEdge[pos];
+    }
+
+    Edge* inEdge(int pos) const
+    {
+      return predEdge[pos];
+    }
+
+  private:
+    Q_DISABLE_COPY(Adjacency)
+
+    QVector<Vertex::Ptr>         vertexList;
+    QHash<const Vertex*,int>     indexMap;
+    QVector<int>                 succOffset;
+    QVector<int>                 succVertex;
+    QVector<Edge*>               succEdge;
+    QVector<int>                 predOffset;
+    QVector<int>                 predVertex;
+    QVector<Edge*>               predEdge;
   };
 
   class GraphBase : public QObject, public Serializer
@@ -196,10 +308,24 @@ namespace graph
     bool addEdge(Edge::Ptr edge);
     bool removeEdge(Edge::Ptr edge);
 
+    // Transactions group structural changes. Status updates are collected until the outermost
+    // endUpdate() and then emitted once per kind of change. Calls may be nested.
+    void beginUpdate();
+    void endUpdate();
+
+    bool updateActive() const
+    {
+      return updateLevel > 0;
+    }
+
     virtual void save(QXmlStreamWriter& stream) const;
 
     virtual bool load(QXmlStreamReader& stream, ElementManager& manager);
 
+    virtual void save(BinaryWriter& stream) const;
+
+    virtual bool load(BinaryReader& stream, ElementManager& manager);
+
     enum StatusChange
     {
       Name,
@@ -212,7 +338,12 @@ namespace graph
 
     typedef QMultiMap<int,Vertex::Ptr> ComponentMap;
 
+    // weakly connected components numbered in the order of their first vertex
     const ComponentMap components() const;
+    int countComponents() const;
+
+    // snapshot of the current structure, rebuilt on first use after vertices or edges were added or removed
+    Adjacency::Ptr adjacency() const;
 
   signals:
     void vertexAdded(Vertex::Ptr vertex);
@@ -228,7 +359,16 @@ namespace graph
     typedef QMap<QUuid, Vertex::Ptr> VertexMap;
     typedef QMap<QUuid, Edge::Ptr>   EdgeMap;
 
-    void visitVertex(Vertex* vertex, int compNr, QMap<QUuid,int>& components) const;
+    bool loadElements(QXmlStreamReader& stream, ElementManager& manager);
+    bool loadElements(BinaryReader& stream, ElementManager& manager);
+    QString loadWarnings(const QStringList& msgWarningsVertices, const QStringList& msgWarningsEdges) const;
+    void notifyStatus(int change);
+    Vertex* componentRoot(Vertex* vertex) const;
+    void joinComponents(Vertex* vertex1, Vertex* vertex2);
+    void splitComponent(Vertex* vertex1, Vertex* vertex2);
+    void rebuildComponents() const;
+    // called after the coalesced status updates of a transaction were emitted
+    virtual void updateFinished() {}
 
     VertexMap      vertices;
     EdgeMap        edges;
@@ -237,6 +377,15 @@ namespace graph
     QUuid          lockId;
     Scene::Ptr     graphScene;
     mutable QMutex mutex;
+    mutable Adjacency::Ptr adjacencySnapshot;
+    int            updateLevel;
+    QList<int>     updatesPending;
+    // union find forest of the weakly connected components, each root knows the size of its component
+    mutable QHash<Vertex*,Vertex*> componentParent;
+    mutable QHash<Vertex*,int>     componentSize;
+    mutable bool                   componentsValid;
+    mutable ComponentMap           componentMap;
+    mutable bool                   componentMapValid;
   };
 
   class DirectedGraph : public GraphBase
@@ -280,6 +429,13 @@ namespace graph
       return vertexInfo[id].inCycle;
     }
 
+    int vertexChain(QUuid id) const
+    {
+      QMutexLocker lock(&mutex);
+      if (!linearChainsValid) findLinearChains();
+      return linearChainIndex.value(id,-1);
+    }
+
     int strongComponentsCount();
 
     bool strongComponent(int index, GraphBase::ComponentMap& result);
@@ -287,6 +443,13 @@ namespace graph
     const ComponentMap& topologicalOrder();
     const ComponentMap& strongComponents();
 
+    // maximal chains of vertices where each vertex is the only successor of its predecessor
+    // and the only predecessor of its successor, ordered from head to tail
+    typedef QList<Vertex::Ptr> LinearChain;
+    typedef QList<LinearChain> LinearChainList;
+
+    const LinearChainList& linearChains();
+
     enum StatusChange
     {
       TopologicalOrder = GraphBase::StatusChange_End + 1,
@@ -297,6 +460,10 @@ namespace graph
   protected slots:
     virtual void vertexChanged(graph::BaseElement& element, int reason);
     virtual void graphChanged(int reason);
+    void onVertexAdded(Vertex::Ptr vertex);
+    void onVertexToBeRemoved(Vertex::Ptr vertex);
+    void onEdgeAdded(Edge::Ptr edge);
+    void onEdgeToBeRemoved(Edge::Ptr edge);
 
   protected:
     class DirectedVertexInfo
@@ -309,16 +476,28 @@ namespace graph
 
     typedef QMap<QUuid,DirectedVertexInfo> VertexInfoMap;
 
-    void visitVertex(Vertex* vertex, QSet<Vertex*>& verticesVisited, int order, VertexInfoMap& vertexMap);
-    int visitVertex(Vertex* vertex, QMap<QUuid,int>& verticesVisited, int id, VertexMap& vertices, QStack<Vertex*>& stack, ComponentMap& components);
+    void rebuildTopologicalOrder();
+    bool orderAcyclicVertices(VertexInfoMap& vertexMap) const;
+    bool relabelVertices(Vertex* start, Vertex* cycleVertex);
+    void orderCyclicVertices(VertexInfoMap& vertexMap) const;
+    void findStrongComponents(ComponentMap& components) const;
+    int labelStrongComponents(const Adjacency::Ptr& snapshot, QVector<int>& component) const;
+    void findLinearChains() const;
+    virtual void updateFinished();
+    Vertex* uniqueNeighbour(Vertex* vertex, Defines::PinDirectionType direction) const;
 
     VertexInfoMap vertexInfo;
     ComponentMap  topologicalOrderMap;
     bool          topologicalOrderUpdatedRequired;
     bool          topologicalOrderAutoUpdate;
+    bool          topologicalOrderIncremental;
     ComponentMap  strongComponentMap;
     bool          strongComponentsUpdatedRequired;
     bool          strongComponentsAutoUpdate;
+    // chains are found on demand, changes of the order only invalidate them
+    mutable LinearChainList    linearChainList;
+    mutable QHash<QUuid,int>   linearChainIndex;
+    mutable bool               linearChainsValid;
   };
 
 }
@@ -29,12 +29,16 @@
 
 namespace graph
 {
+  bool Serializer::visualization = true;
+  QHash<Serializer::ClassKey,Serializer::ClassInfoPtr> Serializer::classCache;
+  QMutex Serializer::classCacheMutex;
 
-  Serializer::Serializer(const QString& element, int startIndex, QObject* objPtr) : elementName(element), propertyOffset(startIndex), obj(objPtr)
+  Serializer::Serializer(const QString& element, int startIndex, QObject* objPtr) : elementName(element), propertyOffset(startIndex), obj(objPtr),
+    lookAhead(LookAheadNone)
   {
   }
 
-  Serializer::Serializer() : elementName("default"), propertyOffset(1)
+  Serializer::Serializer() : elementName("default"), propertyOffset(1), obj(0), lookAhead(LookAheadNone)
   {
   }
 
@@ -42,6 +46,58 @@ namespace graph
   {
   }
 
+  Serializer::ClassInfoPtr Serializer::classInfo() const
+  {
+    const QMetaObject* metaobject = obj->metaObject();
+    ClassKey key(metaobject,propertyOffset);
+    QMutexLocker lock(&classCacheMutex);
+    ClassInfoPtr info = classCache.value(key);
+    if (info.isNull())
+    {
+      // property kinds are derived from the declared types, stored flags are assumed to be the same for all instances
+      ClassInfo* newInfo = new ClassInfo();
+      newInfo->className = QString::fromLatin1(metaobject->className());
+      int total = metaobject->propertyCount();
+      for (int i = propertyOffset; i < total; ++i)
+      {
+        QMetaProperty metaproperty = metaobject->property(i);
+        if (!metaproperty.isStored(obj)) continue;
+        PropertyInfo prop;
+        prop.property = metaproperty;
+        prop.name = QString::fromLatin1(metaproperty.name());
+        int type = metaproperty.userType();
+        if (metaproperty.isEnumType() || metaproperty.isFlagType())
+        {
+          prop.kind = KindEnum;
+        }
+        else if (type == qMetaTypeId<graph::Scene::Ptr>())
+        {
+          prop.kind = KindScene;
+        }
+        else if (type == qMetaTypeId<graph::BaseItem::Ptr>())
+        {
+          prop.kind = KindItem;
+        }
+        else if (type == qMetaTypeId<graph::BaseData::Ptr>())
+        {
+          prop.kind = KindData;
+        }
+        else if (QVariant(type,0).canConvert<QString>())
+        {
+          prop.kind = KindText;
+        }
+        else
+        {
+          prop.kind = KindUnsupported;
+        }
+        newInfo->properties.append(prop);
+      }
+      info = ClassInfoPtr(newInfo);
+      classCache.insert(key,info);
+    }
+    return info;
+  }
+
   void Serializer::save(QXmlStreamWriter& stream) const
   {
     writeElementStart(stream);
@@ -57,12 +113,25 @@ namespace graph
     return true;
   }
 
+  void Serializer::save(BinaryWriter& stream) const
+  {
+    writeElementStart(stream);
+    writeProperties(stream);
+    writeElementEnd(stream);
+  }
+
+  bool Serializer::load(BinaryReader& stream)
+  {
+    if (!readElementStart(stream)) return false;
+    if (!readProperties(stream)) return false;
+    if (!readElementEnd(stream)) return false;
+    return true;
+  }
+
   void Serializer::writeElementStart(QXmlStreamWriter& stream) const
   {
     stream.writeStartElement(elementName);
-    const QMetaObject *metaobject = obj->metaObject();
-    QString className = QString::fromLatin1(metaobject->className());
-    stream.writeAttribute("class",className);
+    stream.writeAttribute("class",classInfo()->className);
     const BaseElement* baseElement = qobject_cast<const BaseElement*>(obj);
     if (baseElement)
     {
@@ -96,20 +165,16 @@ namespace graph
 
   void Serializer::writeProperties(QXmlStreamWriter& stream) const
   {
-    const QMetaObject *metaobject = obj->metaObject();
-    int total = metaobject->propertyCount();
-    for (int i = propertyOffset; i < total; ++i)
+    ClassInfoPtr info = classInfo();
+    foreach(const PropertyInfo& prop, info->properties)
     {
-      QMetaProperty metaproperty = metaobject->property(i);
-      const char* name = metaproperty.name();
-      QVariant propValue = obj->property(name);
-      //qDebug() << name << " " << metaproperty.typeName() << " " << metaproperty.userType() << " " << metaproperty.type();
-      if (metaproperty.isEnumType())
+      QVariant propValue = prop.property.read(obj);
+      if (prop.kind == KindEnum)
       {
-        QMetaEnum metaEnum = metaproperty.enumerator();
-        stream.writeTextElement(QString(name),QString(metaEnum.valueToKey(propValue.toInt())));
+        QMetaEnum metaEnum = prop.property.enumerator();
+        stream.writeTextElement(prop.name,QString(metaEnum.valueToKey(propValue.toInt())));
       }
-      else if (propValue.canConvert<graph::Scene::Ptr>())
+      else if (prop.kind == KindScene)
       {
         Scene::Ptr ptr = propValue.value<graph::Scene::Ptr>();
         if (!ptr.isNull())
@@ -118,12 +183,12 @@ namespace graph
         }
         else
         {
-          stream.writeStartElement(QString(name));
+          stream.writeStartElement(prop.name);
           stream.writeAttribute("class","");
           stream.writeEndElement();
         }
       }
-      else if (propValue.canConvert<graph::BaseItem::Ptr>())
+      else if (prop.kind == KindItem)
       {
         BaseItem::Ptr ptr = propValue.value<graph::BaseItem::Ptr>();
         if (!ptr.isNull())
@@ -132,12 +197,12 @@ namespace graph
         }
         else
         {
-          stream.writeStartElement(QString(name));
+          stream.writeStartElement(prop.name);
           stream.writeAttribute("class","");
           stream.writeEndElement();
         }
       }
-      else if (propValue.canConvert<graph::BaseData::Ptr>())
+      else if (prop.kind == KindData)
       {
         BaseData::Ptr ptr = propValue.value<graph::BaseData::Ptr>();
         if (!ptr.isNull())
@@ -146,18 +211,18 @@ namespace graph
         }
         else
         {
-          stream.writeStartElement(QString(name));
+          stream.writeStartElement(prop.name);
           stream.writeAttribute("class","");
           stream.writeEndElement();
         }
       }
-      else if (propValue.canConvert<QString>())
+      else if (prop.kind == KindText)
       {
-        stream.writeTextElement(QString(name),propValue.toString());
+        stream.writeTextElement(prop.name,propValue.toString());
       }
       else
       {
-        stream.writeTextElement(QString(name),"");
+        stream.writeTextElement(prop.name,"");
       }
     }
   }
@@ -174,7 +239,7 @@ namespace graph
     {
       // read class attribute
       QString classNameXML = stream.attributes().value("class").toString();
-      QString classNameObj = QString(obj->metaObject()->className());
+      const QString& classNameObj = classInfo()->className;
       if (classNameXML != classNameObj)
       {
         stream.raiseError(QString(QObject::tr("At line %1, column %2: Read class name '%3' does not match instantiated class '%4' for element '%5'.")).arg(stream.lineNumber()).arg(stream.columnNumber()).arg(classNameXML).arg(classNameObj).arg(elementName));
@@ -200,42 +265,72 @@ namespace graph
 
   bool Serializer::readElementEnd(QXmlStreamReader &stream)
   {
-    stream.skipCurrentElement();
+    // an element read ahead is skipped first, the enclosing element is already closed if its end was read ahead
+    if (lookAhead == LookAheadElement)
+    {
+      stream.skipCurrentElement();
+    }
+    if (lookAhead != LookAheadEnd)
+    {
+      stream.skipCurrentElement();
+    }
+    lookAhead = LookAheadNone;
     return true;
   }
 
+  bool Serializer::readNextStartElement(QXmlStreamReader &stream)
+  {
+    LookAhead token = lookAhead;
+    lookAhead = LookAheadNone;
+    if (token == LookAheadNone)
+    {
+      return stream.readNextStartElement();
+    }
+    return token == LookAheadElement;
+  }
+
   bool Serializer::readProperties(QXmlStreamReader &stream)
   {
-    const QMetaObject *metaobject = obj->metaObject();
-    QString className = QString(metaobject->className());
-    int total = metaobject->propertyCount();
-    for (int i = propertyOffset; i < total; ++i)
+    ClassInfoPtr info = classInfo();
+    const QString& className = info->className;
+    lookAhead = LookAheadNone;
+    foreach(const PropertyInfo& prop, info->properties)
     {
-      QMetaProperty metaproperty = metaobject->property(i);
-      const char* name = metaproperty.name();
-      // read element matching property
-      if (stream.readNextStartElement() && stream.name() == QString(name))
+      // read element matching property, an element not matching an optional property is kept for the next one
+      if (lookAhead == LookAheadNone)
+      {
+        lookAhead = (stream.readNextStartElement()) ? LookAheadElement : LookAheadEnd;
+      }
+      if (lookAhead == LookAheadElement && stream.name() == prop.name)
       {
-        QVariant propValue = obj->property(name);
-        if (propValue.canConvert<graph::Scene::Ptr>())
+        lookAhead = LookAheadNone;
+        if (prop.kind == KindScene)
         {
           QString sceneClass = stream.attributes().value("class").toString();
           GraphBase* graphBase = qobject_cast<GraphBase*>(obj);
           if (!sceneClass.isEmpty() && graphBase)
           {
-            if (!graphBase->scene()->load(stream)) return false;
+            if (!visualization)
+            {
+              stream.skipCurrentElement();
+            }
+            else if (!graphBase->scene()->load(stream)) return false;
           }
         }
-        else if (propValue.canConvert<graph::BaseItem::Ptr>())
+        else if (prop.kind == KindItem)
         {
           QString itemClass = stream.attributes().value("class").toString();
           BaseElement* baseElement = qobject_cast<BaseElement*>(obj);
           if (!itemClass.isEmpty() && baseElement)
           {
-            if (!baseElement->sceneItem()->load(stream)) return false;
+            if (!visualization)
+            {
+              stream.skipCurrentElement();
+            }
+            else if (!baseElement->sceneItem()->load(stream)) return false;
           }
         }
-        else if (propValue.canConvert<graph::BaseData::Ptr>())
+        else if (prop.kind == KindData)
         {
           QString dataClass = stream.attributes().value("class").toString();
           BaseElement* baseElement = qobject_cast<BaseElement*>(obj);
@@ -244,49 +339,226 @@ namespace graph
             if (!baseElement->baseDataRef()->load(stream)) return false;
           }
         }
-        else if (propValue.canConvert<QString>())
+        else if (prop.kind == KindText || prop.kind == KindEnum)
         {
           QString content = stream.readElementText();
-          if (metaproperty.isWritable())
+          if (!readValue(prop,content))
           {
-            bool propSet = true;
-            bool valueSet = true;
-            if (metaproperty.isEnumType() || metaproperty.isFlagType())
+            if (prop.property.isWritable())
             {
-              QMetaEnum metaEnum = metaproperty.enumerator();
-              propSet = obj->setProperty(name,QVariant(metaEnum.keyToValue(content.toLatin1().data(),&valueSet)));
+              stream.raiseError(QString(QObject::tr("At line %1, column %2: Failed to set value '%3' for property '%4' of class instance '%5' (element '%6').")).arg(stream.lineNumber()).arg(stream.columnNumber()).arg(content).arg(prop.name).arg(className).arg(elementName));
             }
             else
             {
-              propSet = obj->setProperty(name,QVariant(content));
-            }
-            if (!propSet || !valueSet)
-            {
-              stream.raiseError(QString(QObject::tr("At line %1, column %2: Failed to set value '%3' for property '%4' of class instance '%5' (element '%6').")).arg(stream.lineNumber()).arg(stream.columnNumber()).arg(content).arg(QString(name)).arg(className).arg(elementName));
-              return false;
-            }
-          }
-          else
-          {
-            QString value = obj->property(name).toString();
-            if (content != value)
-            {
-              stream.raiseError(QString(QObject::tr("At line %1, column %2: Constant value '%3' for read-only property '%4' of class instance '%5' does not match read content '%6' of element '%7'.")).arg(stream.lineNumber()).arg(stream.columnNumber()).arg(value).arg(QString(name)).arg(className).arg(content).arg(elementName));
-              return false;
+              stream.raiseError(QString(QObject::tr("At line %1, column %2: Constant value '%3' for read-only property '%4' of class instance '%5' does not match read content '%6' of element '%7'.")).arg(stream.lineNumber()).arg(stream.columnNumber()).arg(prop.property.read(obj).toString()).arg(prop.name).arg(className).arg(content).arg(elementName));
             }
+            return false;
           }
         }
         else
         {
-          stream.raiseError(QString(QObject::tr("At line %1, column %2: Unsupported value type '%3' for property '%4' of class instance '%5' (element '%6').")).arg(stream.lineNumber()).arg(stream.columnNumber()).arg(QString(metaproperty.typeName())).arg(QString(name)).arg(className).arg(elementName));
+          stream.raiseError(QString(QObject::tr("At line %1, column %2: Unsupported value type '%3' for property '%4' of class instance '%5' (element '%6').")).arg(stream.lineNumber()).arg(stream.columnNumber()).arg(QString(prop.property.typeName())).arg(prop.name).arg(className).arg(elementName));
           return false;
         }
       }
+      else if (prop.property.isResettable())
+      {
+        prop.property.reset(obj);
+      }
+      else
+      {
+        stream.raiseError(QString(QObject::tr("At line %1, column %2: Failed to read element for property '%3' of class instance '%4' (element '%5').")).arg(stream.lineNumber()).arg(stream.columnNumber()).arg(prop.name).arg(className).arg(elementName));
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool Serializer::readValue(const PropertyInfo& prop, const QString& content)
+  {
+    // writable properties are set, read-only properties have to match the stored content
+    if (prop.property.isWritable())
+    {
+      if (prop.kind == KindEnum)
+      {
+        bool valueSet = true;
+        int value = prop.property.enumerator().keyToValue(content.toLatin1().data(),&valueSet);
+        return valueSet && prop.property.write(obj,QVariant(value));
+      }
+      return prop.property.write(obj,QVariant(content));
+    }
+    return content == prop.property.read(obj).toString();
+  }
+
+  void Serializer::writeElementStart(BinaryWriter& stream) const
+  {
+    // signatures and pin ids of graph elements are stored by the graph before the element record
+    stream.beginRecord();
+    stream.writeString(classInfo()->className);
+    const BaseElement* baseElement = qobject_cast<const BaseElement*>(obj);
+    if (baseElement)
+    {
+      stream.writeUuid(baseElement->id());
+    }
+  }
+
+  void Serializer::writeElementEnd(BinaryWriter& stream) const
+  {
+    stream.endRecord();
+  }
+
+  void Serializer::writeProperties(BinaryWriter& stream) const
+  {
+    ClassInfoPtr info = classInfo();
+    foreach(const PropertyInfo& prop, info->properties)
+    {
+      QVariant propValue = prop.property.read(obj);
+      stream.writeString(prop.name);
+      if (prop.kind == KindEnum)
+      {
+        QMetaEnum metaEnum = prop.property.enumerator();
+        stream.writeUInt8(BinaryFormat::PropertyEnum);
+        stream.writeString(QString(metaEnum.valueToKey(propValue.toInt())));
+      }
+      else if (prop.kind == KindScene)
+      {
+        Scene::Ptr ptr = propValue.value<graph::Scene::Ptr>();
+        stream.writeUInt8(ptr.isNull() ? BinaryFormat::PropertyNull : BinaryFormat::PropertyScene);
+        if (!ptr.isNull()) ptr->save(stream);
+      }
+      else if (prop.kind == KindItem)
+      {
+        BaseItem::Ptr ptr = propValue.value<graph::BaseItem::Ptr>();
+        stream.writeUInt8(ptr.isNull() ? BinaryFormat::PropertyNull : BinaryFormat::PropertyItem);
+        if (!ptr.isNull()) ptr->save(stream);
+      }
+      else if (prop.kind == KindData)
+      {
+        BaseData::Ptr ptr = propValue.value<graph::BaseData::Ptr>();
+        stream.writeUInt8(ptr.isNull() ? BinaryFormat::PropertyNull : BinaryFormat::PropertyData);
+        if (!ptr.isNull()) ptr->save(stream);
+      }
       else
       {
-        stream.raiseError(QString(QObject::tr("At line %1, column %2: Failed to read element for property '%3' of class instance '%4' (element '%5').")).arg(stream.lineNumber()).arg(stream.columnNumber()).arg(QString(name)).arg(className).arg(elementName));
+        stream.writeUInt8(BinaryFormat::PropertyText);
+        stream.writeString((prop.kind == KindText) ? propValue.toString() : QString());
+      }
+    }
+  }
+
+  bool Serializer::readElementStart(BinaryReader& stream)
+  {
+    if (!stream.beginRecord()) return false;
+    QString classNameFile = stream.readString();
+    const QString& classNameObj = classInfo()->className;
+    if (classNameFile != classNameObj)
+    {
+      stream.raiseError(QString(QObject::tr("At offset %1: Read class name '%2' does not match instantiated class '%3' for element '%4'.")).arg(stream.offset()).arg(classNameFile).arg(classNameObj).arg(elementName));
+      return false;
+    }
+    BaseElement* baseElement = qobject_cast<BaseElement*>(obj);
+    if (baseElement)
+    {
+      QUuid id = stream.readUuid();
+      if (id.isNull())
+      {
+        stream.raiseError(QString(QObject::tr("At offset %1: Element '%2' with class '%3' has an invalid id '%4'.")).arg(stream.offset()).arg(elementName).arg(classNameObj).arg(id.toString()));
+        return false;
+      }
+      baseElement->setId(id);
+    }
+    return !stream.hasError();
+  }
+
+  bool Serializer::readElementEnd(BinaryReader& stream)
+  {
+    stream.endRecord();
+    return !stream.hasError();
+  }
+
+  bool Serializer::readProperties(BinaryReader& stream)
+  {
+    // the stored type tag selects how to read each value, no probing of the current property value needed
+    ClassInfoPtr info = classInfo();
+    const QString& className = info->className;
+    foreach(const PropertyInfo& prop, info->properties)
+    {
+      if (stream.atRecordEnd() || stream.peekString() != prop.name)
+      {
+        if (prop.property.isResettable())
+        {
+          prop.property.reset(obj);
+          continue;
+        }
+        stream.raiseError(QString(QObject::tr("At offset %1: Failed to read element for property '%2' of class instance '%3' (element '%4').")).arg(stream.offset()).arg(prop.name).arg(className).arg(elementName));
         return false;
       }
+      stream.readString();
+      quint8 type = stream.readUInt8();
+      switch(type)
+      {
+        case BinaryFormat::PropertyNull:
+          break;
+        case BinaryFormat::PropertyScene:
+        {
+          GraphBase* graphBase = qobject_cast<GraphBase*>(obj);
+          if (!visualization || !graphBase)
+          {
+            stream.skipRecord();
+          }
+          else if (!graphBase->scene()->load(stream)) return false;
+          break;
+        }
+        case BinaryFormat::PropertyItem:
+        {
+          BaseElement* baseElement = qobject_cast<BaseElement*>(obj);
+          if (!visualization || !baseElement)
+          {
+            stream.skipRecord();
+          }
+          else if (!baseElement->sceneItem()->load(stream)) return false;
+          break;
+        }
+        case BinaryFormat::PropertyData:
+        {
+          BaseElement* baseElement = qobject_cast<BaseElement*>(obj);
+          if (!baseElement)
+          {
+            stream.skipRecord();
+          }
+          else if (!baseElement->baseDataRef()->load(stream)) return false;
+          break;
+        }
+        case BinaryFormat::PropertyText:
+        case BinaryFormat::PropertyEnum:
+        {
+          QString content = stream.readString();
+          if (prop.kind == KindUnsupported)
+          {
+            stream.raiseError(QString(QObject::tr("At offset %1: Unsupported value type '%2' for property '%3' of class instance '%4' (element '%5').")).arg(stream.offset()).arg(QString(prop.property.typeName())).arg(prop.name).arg(className).arg(elementName));
+            return false;
+          }
+          if ((type == BinaryFormat::PropertyEnum) != (prop.kind == KindEnum) || !readValue(prop,content))
+          {
+            if (prop.property.isWritable())
+            {
+              stream.raiseError(QString(QObject::tr("At offset %1: Failed to set value '%2' for property '%3' of class instance '%4' (element '%5').")).arg(stream.offset()).arg(content).arg(prop.name).arg(className).arg(elementName));
+            }
+            else
+            {
+              stream.raiseError(QString(QObject::tr("At offset %1: Constant value '%2' for read-only property '%3' of class instance '%4' does not match read content '%5' of element '%6'.")).arg(stream.offset()).arg(prop.property.read(obj).toString()).arg(prop.name).arg(className).arg(content).arg(elementName));
+            }
+            return false;
+          }
+          break;
+        }
+        default:
+        {
+          stream.raiseError(QString(QObject::tr("At offset %1: Unsupported value type %2 for property '%3' of class instance '%4' (element '%5').")).arg(stream.offset()).arg(type).arg(prop.name).arg(className).arg(elementName));
+          return false;
+        }
+      }
+      if (stream.hasError()) return false;
     }
     return true;
   }
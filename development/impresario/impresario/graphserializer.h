@@ -21,9 +21,17 @@
 #ifndef GRAPHSERIALIZER_H
 #define GRAPHSERIALIZER_H
 
+#include "graphbinary.h"
 #include <QObject>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
+#include <QMetaObject>
+#include <QMetaProperty>
+#include <QSharedPointer>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
 
 namespace graph
 {
@@ -36,6 +44,8 @@ namespace graph
 
     virtual void save(QXmlStreamWriter& stream) const;
     virtual bool load(QXmlStreamReader& stream);
+    virtual void save(BinaryWriter& stream) const;
+    virtual bool load(BinaryReader& stream);
 
     const QString& element() const
     {
@@ -57,20 +67,83 @@ namespace graph
       propertyOffset = startIndex;
     }
 
+    // if disabled, scenes and items stored in files are skipped on loading, e.g. to run graphs without GUI
+    static void enableVisualization(bool enable = true)
+    {
+      visualization = enable;
+    }
+
+    static bool visualizationEnabled()
+    {
+      return visualization;
+    }
+
   protected:
     void writeElementStart(QXmlStreamWriter& stream) const;
     void writeElementEnd(QXmlStreamWriter& stream) const;
     void writeProperties(QXmlStreamWriter& stream) const;
     bool readElementStart(QXmlStreamReader& stream);
     bool readElementEnd(QXmlStreamReader& stream);
+    // resettable properties are optional, they are reset if missing in the stream, e.g. in files of older versions
     bool readProperties(QXmlStreamReader& stream);
+    // to be used instead of QXmlStreamReader::readNextStartElement() for elements following the properties
+    bool readNextStartElement(QXmlStreamReader& stream);
+    void writeElementStart(BinaryWriter& stream) const;
+    void writeElementEnd(BinaryWriter& stream) const;
+    void writeProperties(BinaryWriter& stream) const;
+    bool readElementStart(BinaryReader& stream);
+    bool readElementEnd(BinaryReader& stream);
+    bool readProperties(BinaryReader& stream);
 
   private:
     Serializer();
 
-    QString  elementName;
-    int      propertyOffset;
-    QObject* obj;
+    enum PropertyKind
+    {
+      KindText,
+      KindEnum,
+      KindScene,
+      KindItem,
+      KindData,
+      KindUnsupported
+    };
+
+    struct PropertyInfo
+    {
+      QMetaProperty property;
+      QString       name;
+      PropertyKind  kind;
+    };
+
+    // stored properties of a class resolved once, shared by all instances with the same property start index
+    struct ClassInfo
+    {
+      QString               className;
+      QVector<PropertyInfo> properties;
+    };
+
+    // token already read by readProperties() when optional properties are missing in the stream
+    enum LookAhead
+    {
+      LookAheadNone,
+      LookAheadElement,
+      LookAheadEnd
+    };
+
+    typedef QSharedPointer<const ClassInfo> ClassInfoPtr;
+    typedef QPair<const QMetaObject*,int>   ClassKey;
+
+    ClassInfoPtr classInfo() const;
+    bool readValue(const PropertyInfo& prop, const QString& content);
+
+    static bool visualization;
+    static QHash<ClassKey,ClassInfoPtr> classCache;
+    static QMutex                       classCacheMutex;
+
+    QString   elementName;
+    int       propertyOffset;
+    QObject*  obj;
+    LookAhead lookAhead;
   };
 }
 #endif // GRAPHSERIALIZER_H
@@ -103,6 +103,9 @@ SOURCES += main.cpp \
     graphmain.cpp \
     appmacromanager.cpp \
     appprocessgraph.cpp \
+    appexecutor.cpp \
+    apphistogram.cpp \
+    apptrace.cpp \
     graphitems.cpp \
     grapheditor.cpp \
     pgecomponents.cpp \
@@ -112,6 +115,7 @@ SOURCES += main.cpp \
     pgewndprops.cpp \
     graphresources.cpp \
     graphserializer.cpp \
+    graphbinary.cpp \
     stdconsoleinterface.cpp \
     ../components/singleapplication/singleapplication.cpp \
     helpsystem.cpp \
@@ -144,6 +148,9 @@ HEADERS  += appimpresario.h \
     graphmain.h \
     appmacromanager.h \
     appprocessgraph.h \
+    appexecutor.h \
+    apphistogram.h \
+    apptrace.h \
     graphitems.h \
     grapheditor.h \
     pgecomponents.h \
@@ -154,6 +161,7 @@ HEADERS  += appimpresario.h \
     pgewndprops.h \
     graphresources.h \
     graphserializer.h \
+    graphbinary.h \
     stdconsoleinterface.h \
     ../components/singleapplication/singleapplication.h \
     helpsystem.h \
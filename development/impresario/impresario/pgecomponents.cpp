@@ -45,6 +45,7 @@
 #include <QXmlStreamReader>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QUrl>
 #include <QtXmlPatterns/QXmlSchema>
 #include <QtXmlPatterns/QXmlSchemaValidator>
@@ -120,7 +121,7 @@ namespace pge
   // Class ProcessGraphEditor
   //-----------------------------------------------------------------------
   ProcessGraphEditor::ProcessGraphEditor(QWidget* parent) : graph::SceneEditor(processGraph,app::MacroManager::instance(),parent),
-    pgControl(processGraph), pgThread(), pgRunnable(false), pgRunning(false), pgPaused(false), pgSnapped(false), pgUnlockId(),
+    pgControl(processGraph), pgThread(), pgRunnable(false), pgRunning(false), pgPaused(false), pgSnapped(false), pgSettingsModified(false), pgUnlockId(),
     docFileName(), editUndoStack(), dropPos(-1.0,-1.0), viewers()
   {
     setFileName(QString());
@@ -133,6 +134,27 @@ namespace pge
   bool ProcessGraphEditor::load(const QString &fileName)
   {
     QString pgFileName = fileName.split('/').last();
+    // binary process graphs are read directly, the XML schema applies to XML files only
+    QFile binaryFile(fileName);
+    if (binaryFile.open(QIODevice::ReadOnly) && graph::BinaryFormat::isBinary(binaryFile))
+    {
+      syslog::info(QString(tr("%1: Reading process graph from '%2'...")).arg(pgFileName).arg(QDir::toNativeSeparators(fileName)),tr("Process Graph"));
+      graph::BinaryReader stream(binaryFile);
+      if (stream.hasError() || !graph::SceneEditor::load(stream))
+      {
+        syslog::error(pgFileName + ": " + stream.errorString(),tr("Process Graph"));
+        syslog::error(QString(tr("%1: File '%2' not loaded.")).arg(pgFileName).arg(QDir::toNativeSeparators(fileName)),tr("Process Graph"));
+        return false;
+      }
+      if (stream.hasError())
+      {
+        syslog::warning(pgFileName + ": " + stream.errorString(),tr("Process Graph"));
+      }
+      setFileName(fileName);
+      syslog::info(QString(tr("%1: Opened process graph.")).arg(processGraph.name()),tr("Process Graph"));
+      return true;
+    }
+    binaryFile.close();
     // get path to schema file
     QString schemaPath = Resource::getPath(Resource::SETTINGS_PATH_RESOURCES);
     schemaPath += "/processgraph.xsd";
@@ -228,6 +250,18 @@ namespace pge
     item = infoManager.addProperty(QVariant::Int, QObject::tr("Links"));
     item->setValue(graph().countEdges());
     group->addSubProperty(item);
+    item = infoManager.addProperty(QVariant::Int, QObject::tr("Components"));
+    item->setToolTip(QObject::tr("Number of independent sets of connected macros. Each component is processed separately."));
+    item->setValue(graph().countComponents());
+    group->addSubProperty(item);
+    group = infoManager.addProperty(QtVariantPropertyManager::groupTypeId(), QObject::tr("Last run"));
+    item = infoManager.addProperty(QVariant::String, QObject::tr("Critical path"));
+    item->setToolTip(QObject::tr("Best possible frame time with unlimited processor cores based on the mean runtime of each macro"));
+    item->setValue(app::LatencyHistogram::toString(processGraph.criticalPath().length));
+    group->addSubProperty(item);
+    item = infoManager.addProperty(QVariant::String, QObject::tr("Observed frame time"));
+    item->setValue(app::LatencyHistogram::toString(processGraph.observedFrameTime()));
+    group->addSubProperty(item);
 
     QtVariantPropertyManager& propManager = propWnd.stdPropertyManager();
     group = propManager.addProperty(QtVariantPropertyManager::groupTypeId(), QObject::tr("Visualization"));
@@ -237,6 +271,39 @@ namespace pge
     item->setAttribute(QLatin1String("enumNames"), enumLayoutNames);
     item->setValue(static_cast<graph::Scene*>(scene())->graphLayout());
     group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::Bool, QObject::tr("Show critical path"));
+    item->setToolTip(QObject::tr("Highlights the macros and links which determine the frame time of the last run."));
+    item->setValue(processGraph.criticalPathShown());
+    group->addSubProperty(item);
+    // execution settings must not change while the graph is running
+    bool editable = !processGraph.editLockActive();
+    group = propManager.addProperty(QtVariantPropertyManager::groupTypeId(), QObject::tr("Execution"));
+    item = propManager.addProperty(QVariant::Bool, QObject::tr("Pipelined"));
+    item->setValue(processGraph.pipelined());
+    item->setEnabled(editable);
+    group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::Int, QObject::tr("Pipeline depth"));
+    item->setAttribute(QLatin1String("minimum"), 1);
+    item->setAttribute(QLatin1String("maximum"), 64);
+    item->setValue(processGraph.pipelineDepth());
+    item->setEnabled(editable);
+    group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::Int, QObject::tr("Worker threads"));
+    item->setToolTip(QObject::tr("Number of threads executing macros of this graph. 0 uses one thread per processor core."));
+    item->setAttribute(QLatin1String("minimum"), 0);
+    item->setAttribute(QLatin1String("maximum"), 256);
+    item->setValue(processGraph.workerCount());
+    item->setEnabled(editable);
+    group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::Bool, QObject::tr("Fuse linear chains"));
+    item->setValue(processGraph.fuseChains());
+    item->setEnabled(editable);
+    group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::Bool, QObject::tr("Record timeline"));
+    item->setToolTip(QObject::tr("Records when and on which thread each macro runs. Export the timeline after processing has stopped."));
+    item->setValue(processGraph.tracing());
+    item->setEnabled(editable);
+    group->addSubProperty(item);
   }
 
   void ProcessGraphEditor::updateProperties(WndProperties& propWnd) const
@@ -246,6 +313,16 @@ namespace pge
     props[QObject::tr("Instance UUID")]->setValue(graph().id());
     props[QObject::tr("Macros")]->setValue(graph().countVertices());
     props[QObject::tr("Links")]->setValue(graph().countEdges());
+    props[QObject::tr("Components")]->setValue(graph().countComponents());
+    props[QObject::tr("Critical path")]->setValue(app::LatencyHistogram::toString(processGraph.criticalPath().length));
+    props[QObject::tr("Observed frame time")]->setValue(app::LatencyHistogram::toString(processGraph.observedFrameTime()));
+    QMap<QString,QtVariantProperty*>& stdProps = propWnd.stdProperties();
+    bool editable = !processGraph.editLockActive();
+    stdProps[QObject::tr("Pipelined")]->setEnabled(editable);
+    stdProps[QObject::tr("Pipeline depth")]->setEnabled(editable);
+    stdProps[QObject::tr("Worker threads")]->setEnabled(editable);
+    stdProps[QObject::tr("Fuse linear chains")]->setEnabled(editable);
+    stdProps[QObject::tr("Record timeline")]->setEnabled(editable);
   }
 
   void ProcessGraphEditor::propertyChanged(QtVariantProperty& prop)
@@ -256,6 +333,36 @@ namespace pge
       static_cast<graph::Scene*>(scene())->setGraphLayout(static_cast<graph::Defines::LayoutDirectionType>(prop.value().toInt()));
       scene()->update();
     }
+    else if (name == QObject::tr("Show critical path"))
+    {
+      processGraph.showCriticalPath(prop.value().toBool());
+      scene()->update();
+    }
+    else if (name == QObject::tr("Pipelined"))
+    {
+      processGraph.setPipelined(prop.value().toBool());
+      settingsModified();
+    }
+    else if (name == QObject::tr("Pipeline depth"))
+    {
+      processGraph.setPipelineDepth(prop.value().toInt());
+      settingsModified();
+    }
+    else if (name == QObject::tr("Worker threads"))
+    {
+      processGraph.setWorkerCount(prop.value().toInt());
+      settingsModified();
+    }
+    else if (name == QObject::tr("Fuse linear chains"))
+    {
+      processGraph.setFuseChains(prop.value().toBool());
+      settingsModified();
+      scene()->update();
+    }
+    else if (name == QObject::tr("Record timeline"))
+    {
+      processGraph.setTracing(prop.value().toBool());
+    }
   }
 
   bool ProcessGraphEditor::fileSave()
@@ -276,7 +383,7 @@ namespace pge
     QString fileName = QFileDialog::getSaveFileName(this,
                                                     tr("Save ProcessGraph"),
                                                     pgPath,
-                                                    tr("Impresario Process Graphs (*.ipg);; All files (*.*)"));
+                                                    tr("Impresario Process Graphs (*.ipg);; Impresario Binary Process Graphs (*.ipgb);; All files (*.*)"));
     fileName = QDir::toNativeSeparators(fileName);
     if (fileName.isEmpty())
     {
@@ -408,6 +515,38 @@ namespace pge
     ctrlStart();
   }
 
+  void ProcessGraphEditor::ctrlExportStatistics()
+  {
+    QString fileName = QFileDialog::getSaveFileName(this,
+                                                    tr("Export Runtime Statistics"),
+                                                    QFileInfo(docFileName).absolutePath(),
+                                                    tr("CSV files (*.csv);; JSON files (*.json);; All files (*.*)"));
+    if (fileName.isEmpty())
+    {
+      return;
+    }
+    if (processGraph.saveRuntimeStatistics(fileName))
+    {
+      syslog::info(QString(tr("%1: Runtime statistics saved to '%2'.")).arg(processGraph.name()).arg(QDir::toNativeSeparators(fileName)),tr("Process Graph"));
+    }
+  }
+
+  void ProcessGraphEditor::ctrlExportTrace()
+  {
+    QString fileName = QFileDialog::getSaveFileName(this,
+                                                    tr("Export Timeline"),
+                                                    QFileInfo(docFileName).absolutePath(),
+                                                    tr("Trace files (*.json);; All files (*.*)"));
+    if (fileName.isEmpty())
+    {
+      return;
+    }
+    if (processGraph.saveTrace(fileName))
+    {
+      syslog::info(QString(tr("%1: Timeline saved to '%2'.")).arg(processGraph.name()).arg(QDir::toNativeSeparators(fileName)),tr("Process Graph"));
+    }
+  }
+
   void ProcessGraphEditor::macroWatchOutput()
   {
     graph::Pin* pinPtr = reinterpret_cast<graph::Pin*>(Resource::action(Resource::MACRO_WATCHOUTPUT)->data().toULongLong());
@@ -478,11 +617,39 @@ namespace pge
     emit updatePauseCommand(pgRunning);
     emit updateStopCommand(pgRunning);
     emit updateSnapCommand(!pgRunning);
+    processGraph.updateCriticalPath();
+    if (processGraph.observedFrameTime() > 0)
+    {
+      syslog::info(QString(tr("%1: Critical path takes %2 per frame with unlimited cores, observed frame time was %3.")).arg(processGraph.name())
+                   .arg(app::LatencyHistogram::toString(processGraph.criticalPath().length)).arg(app::LatencyHistogram::toString(processGraph.observedFrameTime())),tr("Process Graph"));
+    }
+    if (processGraph.criticalPathShown() && scene())
+    {
+      scene()->update();
+    }
+    // show runtime statistics of the finished run for the selected item
+    PropUpdateInterface* propItem = this;
+    if (scene() && scene()->selectedItems().count() == 1)
+    {
+      PropUpdateInterface* selectedItem = dynamic_cast<PropUpdateInterface*>(scene()->selectedItems().first());
+      if (selectedItem)
+      {
+        propItem = selectedItem;
+      }
+    }
+    emit updatePropWnd(propItem);
   }
 
   void ProcessGraphEditor::processGraphModified(bool clean)
   {
-    setWindowModified(!clean);
+    setWindowModified(!clean || pgSettingsModified);
+  }
+
+  void ProcessGraphEditor::settingsModified()
+  {
+    // settings stored in the file are not part of the undo stack
+    pgSettingsModified = true;
+    setWindowModified(true);
   }
 
   void ProcessGraphEditor::onGraphModified(int status)
@@ -496,6 +663,7 @@ namespace pge
         emit updatePasteCommand(false);
         emit updateUndoCommand(false);
         emit updateRedoCommand(false);
+        emit updatePropWnd(this);
         break;
       case graph::GraphBase::EditingUnlocked:
         emit updateMacroCommands(true);
@@ -503,6 +671,7 @@ namespace pge
         emit updatePasteCommand(QApplication::clipboard()->mimeData() && QApplication::clipboard()->mimeData()->hasFormat("SceneEditor/xml"));
         emit updateUndoCommand(undoStack()->canUndo());
         emit updateRedoCommand(undoStack()->canRedo());
+        emit updatePropWnd(this);
         break;
       case graph::GraphBase::CountVertices:
         pgRunnable = (processGraph.countVertices() > 0 && !processGraph.topologicalOrder().uniqueKeys().contains(-1));
@@ -628,6 +797,9 @@ namespace pge
         popup.addSeparator();
         popup.addAction(ctrlStart);
         popup.addAction(ctrlSnap);
+        popup.addSeparator();
+        popup.addAction(Resource::action(Resource::CTRL_EXPORTSTATS));
+        popup.addAction(Resource::action(Resource::CTRL_EXPORTTRACE));
       }
       else
       {
@@ -687,16 +859,29 @@ namespace pge
 
   bool ProcessGraphEditor::save(const QString& fileName)
   {
+    // files with suffix .ipgb are stored in the binary format, all others as XML
+    bool binary = (QFileInfo(fileName).suffix().compare("ipgb",Qt::CaseInsensitive) == 0);
     QSaveFile file(fileName);
-    if (!file.open(QFile::WriteOnly | QFile::Text))
+    if (!file.open(binary ? QFile::WriteOnly : QFile::WriteOnly | QFile::Text))
     {
       syslog::error(QString(tr("%1: Failed to save graph to file '%2'. %3")).arg(processGraph.name()).arg(fileName).arg(file.errorString()),tr("Process Graph"));
       return false;
     }
     setFileName(fileName);
-    QXmlStreamWriter stream(&file);
-    graph::SceneEditor::save(stream);
-    if (stream.hasError())
+    bool isWritten = true;
+    if (binary)
+    {
+      graph::BinaryWriter stream;
+      graph::SceneEditor::save(stream);
+      isWritten = stream.write(file);
+    }
+    else
+    {
+      QXmlStreamWriter stream(&file);
+      graph::SceneEditor::save(stream);
+      isWritten = !stream.hasError();
+    }
+    if (!isWritten)
     {
       syslog::error(QString(tr("%1: Failed to save graph to file '%2'. %3")).arg(processGraph.name()).arg(fileName).arg(file.errorString()),tr("Process Graph"));
       return false;
@@ -756,6 +941,7 @@ namespace pge
     }
     processGraph.setName(docTitle);
     setWindowTitle(docTitle + "[*]");
+    pgSettingsModified = false;
     setWindowModified(false);
     emit updatePropWnd(this);
   }
@@ -821,12 +1007,12 @@ namespace pge
       return false;
     }
     app::MacroManager& manager = app::MacroManager::instance();
-    if (!manager.hasMacroViewer(macroOutput->getType()))
+    if (!manager.hasMacroViewer(macroOutput->getTypeId()))
     {
       syslog::error(QString(tr("%1: No viewer registered for data type '%2'.")).arg(processGraphName).arg(macroOutput->getType()),tr("Process Graph"));
       return false;
     }
-    viewerMacro = manager.createMacroViewerInstance(macroOutput->getType());
+    viewerMacro = manager.createMacroViewerInstance(macroOutput->getTypeId());
     if (viewerMacro.isNull())
     {
       syslog::error(QString(tr("%1: Failed to create viewer for data type '%2'.")).arg(processGraphName).arg(macroOutput->getType()),tr("Process Graph"));
@@ -107,6 +107,8 @@ namespace pge
     void ctrlPause();
     void ctrlStop();
     void ctrlSnap();
+    void ctrlExportStatistics();
+    void ctrlExportTrace();
     void macroWatchOutput();
 
 
@@ -134,6 +136,7 @@ namespace pge
     bool save(const QString& fileName);
     bool maybeSave();
     void setFileName(const QString &fileName);
+    void settingsModified();
 
     typedef QMap<QUuid,Viewer*> ViewerMap;
 
@@ -144,6 +147,7 @@ namespace pge
     bool                  pgRunning;
     bool                  pgPaused;
     bool                  pgSnapped;
+    bool                  pgSettingsModified;
     QUuid                 pgUnlockId;
     QString               docFileName;
     QUndoStack            editUndoStack;
@@ -23,6 +23,7 @@
 #include "graphresources.h"
 #include "resources.h"
 #include "appmacro.h"
+#include "appprocessgraph.h"
 #include <QPainter>
 #include <QMenu>
 #include <QGraphicsScene>
@@ -214,6 +215,28 @@ namespace pge
   //-----------------------------------------------------------------------
   // Class MacroLinkItem
   //-----------------------------------------------------------------------
+  void MacroLinkItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+  {
+    app::ProcessGraph* pg = qobject_cast<app::ProcessGraph*>(edge().graph().data());
+    if (pg != 0 && pg->criticalPathShown() && pg->criticalPath().edges.contains(edge().id()))
+    {
+      painter->setPen(QPen(QBrush(QColor(220,20,60,160)),8.0,Qt::SolidLine,Qt::RoundCap,Qt::RoundJoin));
+      painter->drawPath(path());
+    }
+    // links inside a fused chain are underlaid with a broad band
+    if (pg != 0 && pg->fuseChains() && destination() != 0)
+    {
+      const graph::Vertex& src = edge().srcPin()->vertex();
+      const graph::Vertex& dest = edge().destPin()->vertex();
+      if (src.linearChain() >= 0 && src.linearChain() == dest.linearChain())
+      {
+        painter->setPen(QPen(QBrush(QColor(255,165,0,128)),6.0,Qt::SolidLine,Qt::RoundCap,Qt::RoundJoin));
+        painter->drawPath(path());
+      }
+    }
+    graph::EdgeItem::paint(painter,option,widget);
+  }
+
   void MacroLinkItem::setupProperties(WndProperties& propWnd) const
   {
     QtVariantPropertyManager& propManager = propWnd.infoPropertyManager();
@@ -367,6 +390,14 @@ namespace pge
       painter->drawPixmap(rcTextOrder.left() - orderStatus.rect().width() - 1.0,rcTextOrder.top(),orderStatus.rect().width(),orderStatus.rect().height(),orderStatus);
     }
     painter->setClipRect(itemRect());
+    // mark macros on the critical path of the last run
+    app::ProcessGraph* pg = qobject_cast<app::ProcessGraph*>(vertex().graph().data());
+    if (pg != 0 && pg->criticalPathShown() && pg->criticalPath().vertices.contains(vertex().id()))
+    {
+      painter->setPen(QPen(QBrush(QColor(220,20,60)),3.0));
+      painter->setBrush(Qt::NoBrush);
+      painter->drawRoundedRect(itemRect().adjusted(1.5,1.5,-1.5,-1.5),10.0,10.0,Qt::AbsoluteSize);
+    }
   }
 
   void MacroItem::setupProperties(WndProperties& propWnd) const
@@ -412,12 +443,37 @@ namespace pge
     item = propManager.addProperty(QVariant::String, QObject::tr("API Version"));
     item->setValue(macro->getLibrary().getAPIVersionString());
     libItem->addSubProperty(item);
+    group = propManager.addProperty(QtVariantPropertyManager::groupTypeId(), QObject::tr("Runtime statistics"));
+    item = propManager.addProperty(QVariant::Int, QObject::tr("Iterations"));
+    group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::String, QObject::tr("Mean"));
+    group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::String, QObject::tr("Minimum"));
+    group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::String, QObject::tr("Median"));
+    group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::String, QObject::tr("95th percentile"));
+    group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::String, QObject::tr("99th percentile"));
+    group->addSubProperty(item);
+    item = propManager.addProperty(QVariant::String, QObject::tr("Maximum"));
+    group->addSubProperty(item);
+    updateProperties(propWnd);
     // setup QML
     propWnd.setQMLProperties(macro.toWeakRef());
   }
 
-  void MacroItem::updateProperties(WndProperties& /*propWnd*/) const
+  void MacroItem::updateProperties(WndProperties& propWnd) const
   {
+    const app::LatencyHistogram& runTimes = vertex().dataRef().staticCast<app::Macro>()->getRuntimeHistogram();
+    QMap<QString,QtVariantProperty*>& props = propWnd.infoProperties();
+    props[QObject::tr("Iterations")]->setValue(static_cast<int>(runTimes.count()));
+    props[QObject::tr("Mean")]->setValue(app::LatencyHistogram::toString(qRound64(runTimes.mean())));
+    props[QObject::tr("Minimum")]->setValue(app::LatencyHistogram::toString(runTimes.min()));
+    props[QObject::tr("Median")]->setValue(app::LatencyHistogram::toString(runTimes.percentile(50.0)));
+    props[QObject::tr("95th percentile")]->setValue(app::LatencyHistogram::toString(runTimes.percentile(95.0)));
+    props[QObject::tr("99th percentile")]->setValue(app::LatencyHistogram::toString(runTimes.percentile(99.0)));
+    props[QObject::tr("Maximum")]->setValue(app::LatencyHistogram::toString(runTimes.max()));
   }
 
   void MacroItem::propertyChanged(QtVariantProperty& /*prop*/)
@@ -49,6 +49,7 @@ namespace pge
     MacroLinkItem(graph::Edge& edgeRef, BaseItem* parent = 0) : graph::EdgeItem(edgeRef,parent) {}
     ~MacroLinkItem() {}
 
+    virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget);
     virtual void setupProperties(WndProperties& propWnd) const;
     virtual void updateProperties(WndProperties& propWnd) const;
     virtual void propertyChanged(QtVariantProperty& prop);
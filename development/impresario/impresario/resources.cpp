@@ -287,6 +287,12 @@ void Resource::initActions()
   action->setShortcut(QKeySequence("F8"));
   action->setStatusTip(QObject::tr("Process the current graph for one cycle"));
   (*actions)[CTRL_SNAP] = action;
+  action = new QAction(QObject::tr("&Export runtime statistics..."), 0);
+  action->setStatusTip(QObject::tr("Save runtime statistics of all macros of the current graph's last run"));
+  (*actions)[CTRL_EXPORTSTATS] = action;
+  action = new QAction(QObject::tr("Export &timeline..."), 0);
+  action->setStatusTip(QObject::tr("Save the timeline of the current graph's last traced run for a trace viewer"));
+  (*actions)[CTRL_EXPORTTRACE] = action;
 
   action = new QAction(QIcon(":/icons/resources/settings.png"), QObject::tr("&Settings..."), 0);
   action->setStatusTip(QObject::tr("Edit Impresario's settings"));
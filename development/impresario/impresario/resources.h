@@ -93,6 +93,8 @@ public:
     CTRL_PAUSE,
     CTRL_STOP,
     CTRL_SNAP,
+    CTRL_EXPORTSTATS,
+    CTRL_EXPORTTRACE,
     EXTRAS_SETTINGS,
     HELP_CONTENT,
     HELP_IDX,